@@ -142,6 +142,11 @@ SUBSECTION
 #include "filenames.h"
 #include "bfdlink.h"
 
+#if BFD_SUPPORTS_PLUGINS
+#include "plugin.h"
+extern const bfd_target plugin_vec;
+#endif
+
 #ifndef errno
 extern int errno;
 #endif
@@ -1895,10 +1900,13 @@ bfd_ar_hdr_from_filesystem (bfd *abfd, const char *filename, bfd *member)
     {
       /* Assume we just "made" the member, and fake it.  */
       struct bfd_in_memory *bim = (struct bfd_in_memory *) member->iostream;
-      time (&status.st_mtime);
+      if (member->mtime_set)
+	status.st_mtime = member->mtime;
+      else
+	time (&status.st_mtime);
       status.st_uid = getuid ();
       status.st_gid = getgid ();
-      status.st_mode = 0644;
+      status.st_mode = S_IFREG | 0644;
       status.st_size = bim->size;
     }
   else if (stat (filename, &status) != 0)
@@ -2276,7 +2284,81 @@ _bfd_write_archive_contents (bfd *arch)
   return FALSE;
 }
 
-/* Note that the namidx for the first symbol is 0.  */
+/* Return TRUE if the symbol map read from the archive ARCH can supply
+   the map entries for members of ARCH that are copied unchanged into
+   an archive written for the target XVEC.  This needs the entries to
+   be sorted by member, as _bfd_compute_and_write_armap writes them.
+   Callers that want the map rebuilt from scratch, as ranlib does,
+   clear bfd_has_map (ARCH).  */
+
+static bfd_boolean
+archive_armap_reusable (bfd *arch, const bfd_target *xvec)
+{
+  struct artdata *ardata;
+  symindex i;
+
+  if (arch->xvec != xvec
+      || bfd_is_thin_archive (arch)
+      || ! bfd_has_map (arch))
+    return FALSE;
+
+#if BFD_SUPPORTS_PLUGINS
+  /* A plugin may claim members and give them symbols that were not
+     in the old map, if that was written without the plugin.  */
+  if (xvec == &plugin_vec && bfd_plugin_specified_p ())
+    return FALSE;
+#endif
+
+  ardata = bfd_ardata (arch);
+  if (ardata == NULL || ardata->symdefs == NULL)
+    return FALSE;
+
+  for (i = 1; i < ardata->symdef_count; i++)
+    if (ardata->symdefs[i - 1].file_offset > ardata->symdefs[i].file_offset)
+      return FALSE;
+
+  return TRUE;
+}
+
+/* Return the first of the entries in the sorted symbol map of ARCH
+   that belong to the member whose header is at FILEPOS, and set *COUNT
+   to the number of such entries.  */
+
+static carsym *
+archive_armap_member_entries (bfd *arch, file_ptr filepos, symindex *count)
+{
+  carsym *symdefs = bfd_ardata (arch)->symdefs;
+  symindex lo = 0;
+  symindex hi = bfd_ardata (arch)->symdef_count;
+  symindex end;
+
+  while (lo < hi)
+    {
+      symindex mid = lo + (hi - lo) / 2;
+
+      if (symdefs[mid].file_offset < filepos)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  for (end = lo;
+       end < bfd_ardata (arch)->symdef_count
+	 && symdefs[end].file_offset == filepos;
+       end++)
+    ;
+
+  *count = end - lo;
+  return symdefs + lo;
+}
+
+/* Note that the namidx for the first symbol is 0.
+
+   Members that are copied unchanged from an archive with a symbol map
+   take their entries from that map, without reading their symbol
+   tables again, so that replacing or adding a few members of a large
+   archive only needs the symbols of those members.  Members with no
+   entries in the old map are read, in case the map was incomplete.  */
 
 bfd_boolean
 _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
@@ -2290,6 +2372,8 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
   int stridx = 0;
   asymbol **syms = NULL;
   long syms_max = 0;
+  bfd *old_arch = NULL;
+  bfd_boolean old_armap_ok = FALSE;
   bfd_boolean ret;
   bfd_size_type amt;
 
@@ -2319,6 +2403,57 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
        current != NULL;
        current = current->archive_next, elt_no++)
     {
+      if (current->my_archive != NULL
+	  && current->arelt_data != NULL
+	  && arch_eltdata (current)->parent_cache != NULL)
+	{
+	  if (current->my_archive != old_arch)
+	    {
+	      old_arch = current->my_archive;
+	      old_armap_ok = archive_armap_reusable (old_arch, arch->xvec);
+	    }
+
+	  if (old_armap_ok)
+	    {
+	      carsym *sym;
+	      symindex count;
+
+	      sym = archive_armap_member_entries (old_arch,
+						  arch_eltdata (current)->key,
+						  &count);
+	      /* A member with no entries is read, in case the old map
+		 was written without its symbols.  */
+	      if (count != 0)
+		{
+		  if (orl_count + count > orl_max)
+		    {
+		      struct orl *new_map;
+
+		      while (orl_count + count > orl_max)
+			orl_max *= 2;
+		      amt = orl_max * sizeof (struct orl);
+		      new_map = (struct orl *) bfd_realloc (map, amt);
+		      if (new_map == NULL)
+			goto error_return;
+
+		      map = new_map;
+		    }
+
+		  /* The names stay allocated until OLD_ARCH is closed.  */
+		  for (; count != 0; count--, sym++)
+		    {
+		      map[orl_count].name = &sym->name;
+		      map[orl_count].u.abfd = current;
+		      map[orl_count].namidx = stridx;
+
+		      stridx += strlen (sym->name) + 1;
+		      ++orl_count;
+		    }
+		  continue;
+		}
+	    }
+	}
+
       if (bfd_check_format (current, bfd_object)
 	  && (bfd_get_file_flags (current) & HAS_SYMS) != 0)
 	{
@@ -2378,16 +2513,15 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
 			(*_bfd_error_handler)
 			  (_("%s: plugin needed to handle lto object"),
 			   bfd_get_filename (current));
+		      /* Allocate the name along with the pointer to it.  */
 		      namelen = strlen (syms[src_count]->name);
-		      amt = sizeof (char *);
+		      amt = sizeof (char *) + namelen + 1;
 		      map[orl_count].name = (char **) bfd_alloc (arch, amt);
 		      if (map[orl_count].name == NULL)
 			goto error_return;
-		      *(map[orl_count].name) = (char *) bfd_alloc (arch,
-								   namelen + 1);
-		      if (*(map[orl_count].name) == NULL)
-			goto error_return;
-		      strcpy (*(map[orl_count].name), syms[src_count]->name);
+		      *(map[orl_count].name) = (char *) (map[orl_count].name + 1);
+		      memcpy (*(map[orl_count].name), syms[src_count]->name,
+			      namelen + 1);
 		      map[orl_count].u.abfd = current;
 		      map[orl_count].namidx = stridx;
 
@@ -2632,6 +2766,8 @@ coff_write_armap (bfd *arch,
   unsigned int count;
   struct ar_hdr hdr;
   int padit = mapsize & 1;
+  bfd_byte *buf;
+  bfd_byte *p;
 
   if (padit)
     mapsize++;
@@ -2655,14 +2791,21 @@ coff_write_armap (bfd *arch,
   _bfd_ar_spacepad (hdr.ar_mode, sizeof (hdr.ar_mode), "%-7lo", 0);
   memcpy (hdr.ar_fmag, ARFMAG, 2);
 
-  /* Write the ar header for this item and the number of symbols.  */
+  /* Write the ar header for this item.  */
   if (bfd_bwrite (&hdr, sizeof (struct ar_hdr), arch)
       != sizeof (struct ar_hdr))
     return FALSE;
 
-  if (!bfd_write_bigendian_4byte_int (arch, symbol_count))
+  /* Build the rest of the map in memory, so that it can be written
+     with a single call rather than one per offset and name.  */
+  buf = (bfd_byte *) bfd_malloc (mapsize);
+  if (buf == NULL)
     return FALSE;
 
+  /* The number of symbols.  */
+  bfd_putb32 (symbol_count, buf);
+  p = buf + 4;
+
   /* Two passes, first write the file offsets for each symbol -
      remembering that each offset is on a two byte boundary.  */
 
@@ -2683,11 +2826,12 @@ coff_write_armap (bfd *arch,
 	  /* Catch an attempt to grow an archive past its 4Gb limit.  */
 	  if (archive_member_file_ptr != (file_ptr) offset)
 	    {
+	      free (buf);
 	      bfd_set_error (bfd_error_file_truncated);
 	      return FALSE;
 	    }
-	  if (!bfd_write_bigendian_4byte_int (arch, offset))
-	    return FALSE;
+	  bfd_putb32 (offset, p);
+	  p += 4;
 	  count++;
 	}
       archive_member_file_ptr += sizeof (struct ar_hdr);
@@ -2706,18 +2850,22 @@ coff_write_armap (bfd *arch,
     {
       size_t len = strlen (*map[count].name) + 1;
 
-      if (bfd_bwrite (*map[count].name, len, arch) != len)
-	return FALSE;
+      memcpy (p, *map[count].name, len);
+      p += len;
     }
 
   /* The spec sez this should be a newline.  But in order to be
      bug-compatible for arc960 we use a null.  */
   if (padit)
+    *p++ = 0;
+
+  if (bfd_bwrite (buf, p - buf, arch) != (bfd_size_type) (p - buf))
     {
-      if (bfd_bwrite ("", 1, arch) != 1)
-	return FALSE;
+      free (buf);
+      return FALSE;
     }
 
+  free (buf);
   return TRUE;
 }
 
@@ -373,6 +373,12 @@ struct bfd_hash_table
   unsigned int entsize;
   /* If non-zero, don't grow the hash table.  */
   unsigned int frozen:1;
+  /* If non-zero, hash strings a word at a time rather than with the
+     traditional byte-at-a-time function.  The bucket an entry lands in
+     then differs, and so does the order of bfd_hash_traverse; only set
+     this, before adding any entries, for tables whose traversal order
+     does not affect the output.  */
+  unsigned int word_hash:1;
 };
 
 /* Initialize a hash table.  */
@@ -523,6 +529,25 @@ extern bfd_boolean bfd_cache_close
 
 extern bfd_boolean bfd_cache_close_all (void);
 
+/* Counts of the file operations done by the BFD file cache.  */
+
+struct bfd_cache_stats
+{
+  /* Files opened, including reopens.  */
+  unsigned long opens;
+  /* Files reopened after being closed.  */
+  unsigned long reopens;
+  /* Files closed to stay within the open file limit.  */
+  unsigned long evictions;
+  /* Read, write and seek system calls, or stdio calls where the
+     cache does not use pread.  */
+  unsigned long reads;
+  unsigned long writes;
+  unsigned long seeks;
+};
+
+extern void bfd_cache_get_stats (struct bfd_cache_stats *);
+
 extern bfd_boolean bfd_record_phdr
   (bfd *, unsigned long, bfd_boolean, flagword, bfd_boolean, bfd_vma,
    bfd_boolean, bfd_boolean, unsigned int, struct bfd_section **);
@@ -380,6 +380,12 @@ struct bfd_hash_table
   unsigned int entsize;
   /* If non-zero, don't grow the hash table.  */
   unsigned int frozen:1;
+  /* If non-zero, hash strings a word at a time rather than with the
+     traditional byte-at-a-time function.  The bucket an entry lands in
+     then differs, and so does the order of bfd_hash_traverse; only set
+     this, before adding any entries, for tables whose traversal order
+     does not affect the output.  */
+  unsigned int word_hash:1;
 };
 
 /* Initialize a hash table.  */
@@ -530,6 +536,25 @@ extern bfd_boolean bfd_cache_close
 
 extern bfd_boolean bfd_cache_close_all (void);
 
+/* Counts of the file operations done by the BFD file cache.  */
+
+struct bfd_cache_stats
+{
+  /* Files opened, including reopens.  */
+  unsigned long opens;
+  /* Files reopened after being closed.  */
+  unsigned long reopens;
+  /* Files closed to stay within the open file limit.  */
+  unsigned long evictions;
+  /* Read, write and seek system calls, or stdio calls where the
+     cache does not use pread.  */
+  unsigned long reads;
+  unsigned long writes;
+  unsigned long seeks;
+};
+
+extern void bfd_cache_get_stats (struct bfd_cache_stats *);
+
 extern bfd_boolean bfd_record_phdr
   (bfd *, unsigned long, bfd_boolean, flagword, bfd_boolean, bfd_vma,
    bfd_boolean, bfd_boolean, unsigned int, struct bfd_section **);
@@ -1845,6 +1870,13 @@ bfd_boolean bfd_get_section_contents
 bfd_boolean bfd_malloc_and_get_section
    (bfd *abfd, asection *section, bfd_byte **buf);
 
+bfd_boolean bfd_map_section_contents
+   (bfd *abfd, asection *section, bfd_byte **buf,
+    void **map_addr, bfd_size_type *map_len);
+
+void bfd_unmap_section_contents
+   (bfd_byte *buf, void *map_addr, bfd_size_type map_len);
+
 bfd_boolean bfd_copy_private_section_data
    (bfd *ibfd, asection *isec, bfd *obfd, asection *osec);
 
@@ -6298,6 +6330,10 @@ struct bfd
      state information on the file here...  */
   ufile_ptr where;
 
+  /* The caching routines read files opened for reading with pread
+     rather than stdio, and keep the file position here.  */
+  ufile_ptr cache_pos;
+
   /* File modified time, if mtime_set is TRUE.  */
   long mtime;
 
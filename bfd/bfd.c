@@ -65,6 +65,10 @@ CODE_FRAGMENT
 .     state information on the file here...  *}
 .  ufile_ptr where;
 .
+.  {* The caching routines read files opened for reading with pread
+.     rather than stdio, and keep the file position here.  *}
+.  ufile_ptr cache_pos;
+.
 .  {* File modified time, if mtime_set is TRUE.  *}
 .  long mtime;
 .
@@ -36,6 +36,13 @@ SECTION
 	close, closes it and opens the one wanted, returning its file
 	handle.
 
+	Archive elements share the file handle of their archive.
+	Where the host has <<pread>>, files opened for reading are
+	read with it rather than through stdio, so that moving between
+	archive elements costs no seek and no buffer refill.  The file
+	position is kept in the <<cache_pos>> field of the outermost
+	BFD, and survives the file being closed and reopened.
+
 SUBSECTION
 	Caching functions
 */
@@ -70,8 +77,10 @@ enum cache_flag {
 
 static int max_open_files = 0;
 
-/* Set max_open_files, if not already set, to 12.5% of the allowed open
-   file descriptors, but at least 10, and return the value.  */
+/* Set max_open_files, if not already set, to 75% of the allowed open
+   file descriptors, but at least 10, and return the value.  The rest
+   is left for the application and for files BFD opens without
+   caching them.  */
 static int
 bfd_cache_max_open (void)
 {
@@ -82,11 +91,11 @@ bfd_cache_max_open (void)
       struct rlimit rlim;
       if (getrlimit (RLIMIT_NOFILE, &rlim) == 0
 	  && rlim.rlim_cur != (rlim_t) RLIM_INFINITY)
-	max = rlim.rlim_cur / 8;
+	max = rlim.rlim_cur / 4 * 3;
       else
 #endif /* HAVE_GETRLIMIT */
 #ifdef _SC_OPEN_MAX
-	max = sysconf (_SC_OPEN_MAX) / 8;
+	max = sysconf (_SC_OPEN_MAX) / 4 * 3;
 #else
 	max = 10;
 #endif /* _SC_OPEN_MAX */
@@ -96,6 +105,29 @@ bfd_cache_max_open (void)
   return max_open_files;
 }
 
+/* Counts of the file operations done by the cache.  */
+
+static struct bfd_cache_stats cache_stats;
+
+/* Whether ABFD, which owns a stream, is read with pread at its
+   cache_pos rather than through the stream.  */
+
+#ifdef HAVE_PREAD
+#define cache_use_pread(abfd) ((abfd)->direction == read_direction)
+#else
+#define cache_use_pread(abfd) FALSE
+#endif
+
+/* Return the BFD owning the stream used by ABFD.  */
+
+static bfd *
+cache_owner (bfd *abfd)
+{
+  while (abfd->my_archive)
+    abfd = abfd->my_archive;
+  return abfd;
+}
+
 /* The number of BFD files we have open.  */
 
 static int open_files;
@@ -194,7 +226,9 @@ close_one (void)
       return TRUE;
     }
 
-  to_kill->where = real_ftell ((FILE *) to_kill->iostream);
+  if (! cache_use_pread (to_kill))
+    to_kill->where = real_ftell ((FILE *) to_kill->iostream);
+  ++cache_stats.evictions;
 
   return bfd_cache_delete (to_kill);
 }
@@ -223,8 +257,7 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
   if ((abfd->flags & BFD_IN_MEMORY) != 0)
     abort ();
 
-  while (abfd->my_archive)
-    abfd = abfd->my_archive;
+  abfd = cache_owner (abfd);
 
   if (abfd->iostream != NULL)
     {
@@ -240,14 +273,20 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
   if (flag & CACHE_NO_OPEN)
     return NULL;
 
-  if (bfd_open_file (abfd) == NULL)
-    ;
-  else if (!(flag & CACHE_NO_SEEK)
-	   && real_fseek ((FILE *) abfd->iostream, abfd->where, SEEK_SET) != 0
-	   && !(flag & CACHE_NO_SEEK_ERROR))
-    bfd_set_error (bfd_error_system_call);
-  else
-    return (FILE *) abfd->iostream;
+  if (bfd_open_file (abfd) != NULL)
+    {
+      ++cache_stats.reopens;
+
+      /* Files read with pread have no stream position to restore.  */
+      if ((flag & CACHE_NO_SEEK) != 0 || cache_use_pread (abfd))
+	return (FILE *) abfd->iostream;
+
+      ++cache_stats.seeks;
+      if (real_fseek ((FILE *) abfd->iostream, abfd->where, SEEK_SET) == 0
+	  || (flag & CACHE_NO_SEEK_ERROR) != 0)
+	return (FILE *) abfd->iostream;
+      bfd_set_error (bfd_error_system_call);
+    }
 
   (*_bfd_error_handler) (_("reopening %B: %s\n"),
 			 orig_bfd, bfd_errmsg (bfd_get_error ()));
@@ -257,7 +296,12 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
 static file_ptr
 cache_btell (struct bfd *abfd)
 {
-  FILE *f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
+  FILE *f;
+
+  if (cache_use_pread (cache_owner (abfd)))
+    return cache_owner (abfd)->cache_pos;
+
+  f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
   if (f == NULL)
     return abfd->where;
   return real_ftell (f);
@@ -266,10 +310,32 @@ cache_btell (struct bfd *abfd)
 static int
 cache_bseek (struct bfd *abfd, file_ptr offset, int whence)
 {
-  FILE *f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : CACHE_NORMAL);
+  bfd *owner = cache_owner (abfd);
+  FILE *f;
+
+  if (cache_use_pread (owner) && whence != SEEK_END)
+    {
+      /* Just move the position used by the next pread.  */
+      if (whence == SEEK_CUR)
+	offset += owner->cache_pos;
+      if (offset < 0)
+	{
+	  errno = EINVAL;
+	  return -1;
+	}
+      owner->cache_pos = offset;
+      return 0;
+    }
+
+  f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : CACHE_NORMAL);
   if (f == NULL)
     return -1;
-  return real_fseek (f, offset, whence);
+  ++cache_stats.seeks;
+  if (real_fseek (f, offset, whence) != 0)
+    return -1;
+  if (cache_use_pread (owner))
+    owner->cache_pos = real_ftell (f);
+  return 0;
 }
 
 /* Note that archive entries don't have streams; they share their parent's.
@@ -296,10 +362,34 @@ cache_bread_1 (struct bfd *abfd, void *buf, file_ptr nbytes)
   if (nbytes == 0)
     return 0;
 
+#ifdef HAVE_PREAD
+  if (cache_use_pread (cache_owner (abfd)))
+    {
+      bfd *owner = cache_owner (abfd);
+
+      f = bfd_cache_lookup (abfd, CACHE_NO_SEEK);
+      if (f == NULL)
+	return 0;
+
+      ++cache_stats.reads;
+      nread = pread (fileno (f), buf, nbytes, owner->cache_pos);
+      if (nread == (file_ptr) -1)
+	{
+	  bfd_set_error (bfd_error_system_call);
+	  return nread;
+	}
+      owner->cache_pos += nread;
+      if (nread < nbytes)
+	bfd_set_error (bfd_error_file_truncated);
+      return nread;
+    }
+#endif
+
   f = bfd_cache_lookup (abfd, CACHE_NORMAL);
   if (f == NULL)
     return 0;
 
+  ++cache_stats.reads;
 #if defined (__VAX) && defined (VMS)
   /* Apparently fread on Vax VMS does not keep the record length
      information.  */
@@ -375,6 +465,7 @@ cache_bwrite (struct bfd *abfd, const void *where, file_ptr nbytes)
 
   if (f == NULL)
     return 0;
+  ++cache_stats.writes;
   nwrite = fwrite (where, 1, nbytes, f);
   if (nwrite < nbytes && ferror (f))
     {
@@ -499,6 +590,7 @@ bfd_cache_init (bfd *abfd)
   abfd->iovec = &cache_iovec;
   insert (abfd);
   ++open_files;
+  ++cache_stats.opens;
   return TRUE;
 }
 
@@ -642,3 +734,22 @@ bfd_open_file (bfd *abfd)
 
   return (FILE *) abfd->iostream;
 }
+
+/*
+FUNCTION
+	bfd_cache_get_stats
+
+SYNOPSIS
+	void bfd_cache_get_stats (struct bfd_cache_stats *stats);
+
+DESCRIPTION
+	Copy into @var{stats} the counts of files opened, reopened and
+	closed by the cache, and of the reads, writes and seeks done on
+	them, since the program started.
+*/
+
+void
+bfd_cache_get_stats (struct bfd_cache_stats *stats)
+{
+  *stats = cache_stats;
+}
@@ -81,6 +81,16 @@ struct adjusted_section
   bfd_vma adj_vma;
 };
 
+/* A section buffer which is a read-only mmap()ed view of the file
+   rather than a malloc'd copy.  */
+struct section_map
+{
+  struct section_map *next;
+  bfd_byte *buffer;
+  void *map_addr;
+  bfd_size_type map_len;
+};
+
 struct dwarf2_debug
 {
   /* A list of all previously read comp_units.  */
@@ -188,6 +198,37 @@ struct dwarf2_debug
 
   /* True if we opened bfd_ptr.  */
   bfd_boolean close_on_cleanup;
+
+  /* Section buffers obtained from bfd_map_section_contents.  */
+  struct section_map *section_maps;
+
+  /* Number of comp_units read so far.  */
+  unsigned int comp_unit_count;
+
+  /* The address ranges of the comp_units in the arange index, sorted
+     by low address, and the number of them.  */
+  struct unit_arange *unit_aranges;
+  bfd_size_type unit_arange_count;
+
+  /* Comp_units in the arange index that have no address range, and
+     must be searched for any address.  */
+  struct comp_unit **unranged_units;
+  unsigned int unranged_unit_count;
+
+  /* Comp_units whose address ranges are not in the arange index,
+     either because they were read or had their ranges extended by
+     line info since the index was last built.  */
+  struct comp_unit *unindexed_units;
+  unsigned int unindexed_unit_count;
+
+#define STASH_UNINDEXED_UNITS_MAX 32
+
+  /* Scratch array of the comp_units that may contain an address.  */
+  struct comp_unit **lookup_units;
+  unsigned int lookup_units_size;
+
+  /* Incremented on each address lookup, to mark units found.  */
+  unsigned int lookup_mark;
 };
 
 struct arange
@@ -197,6 +238,17 @@ struct arange
   bfd_vma high;
 };
 
+/* An entry in the stash's comp_unit arange index.  */
+
+struct unit_arange
+{
+  bfd_vma low;
+  bfd_vma high;
+  /* The largest HIGH of this and all preceding entries.  */
+  bfd_vma high_addr_max;
+  struct comp_unit *unit;
+};
+
 /* A minimal decoding of DWARF2 compilation units.  We only decode
    what's needed to get to the line number information.  */
 
@@ -256,6 +308,11 @@ struct comp_unit
   /* A list of the functions found in this comp. unit.  */
   struct funcinfo *function_table;
 
+  /* The address ranges of the functions above sorted by starting
+     address, built on the first address lookup, and its length.  */
+  struct lookup_funcinfo *lookup_funcinfo_table;
+  bfd_size_type number_of_function_aranges;
+
   /* A list of the variables found in this comp. unit.  */
   struct varinfo *variable_table;
 
@@ -277,6 +334,18 @@ struct comp_unit
 
   /* TRUE if symbols are cached in hash table for faster lookup by name.  */
   bfd_boolean cached;
+
+  /* Position of this unit in reading order, counting from one.  */
+  unsigned int unit_number;
+
+  /* TRUE if the address ranges of this unit are in the stash's arange
+     index.  Otherwise this unit is on the stash's unindexed_units
+     list, chained by next_unindexed_unit.  */
+  bfd_boolean arange_indexed;
+  struct comp_unit *next_unindexed_unit;
+
+  /* The stash lookup_mark of the last lookup that found this unit.  */
+  unsigned int lookup_mark;
 };
 
 /* This data structure holds the information of an abbrev.  */
@@ -490,12 +559,15 @@ lookup_info_hash_table (struct info_hash_table *hash_table, const char *key)
 
 /* Read a section into its appropriate place in the dwarf2_debug
    struct (indicated by SECTION_BUFFER and SECTION_SIZE).  If SYMS is
-   not NULL, use bfd_simple_get_relocated_section_contents to read the
-   section contents, otherwise use bfd_get_section_contents.  Fail if
-   the located section does not contain at least OFFSET bytes.  */
+   not NULL and the section has relocations to apply, use
+   bfd_simple_get_relocated_section_contents to read the section
+   contents, otherwise use bfd_map_section_contents, recording any
+   mapping in STASH.  Fail if the located section does not contain at
+   least OFFSET bytes.  */
 
 static bfd_boolean
 read_section (bfd *           abfd,
+	      struct dwarf2_debug *stash,
 	      const struct dwarf_debug_section *sec,
 	      asymbol **      syms,
 	      bfd_uint64_t    offset,
@@ -524,7 +596,9 @@ read_section (bfd *           abfd,
 	}
 
       *section_size = msec->rawsize ? msec->rawsize : msec->size;
-      if (syms)
+      if (syms
+	  && (abfd->flags & (HAS_RELOC | EXEC_P | DYNAMIC)) == HAS_RELOC
+	  && (msec->flags & SEC_RELOC) != 0)
 	{
 	  *section_buffer
 	    = bfd_simple_get_relocated_section_contents (abfd, msec, NULL, syms);
@@ -533,12 +607,30 @@ read_section (bfd *           abfd,
 	}
       else
 	{
-	  *section_buffer = (bfd_byte *) bfd_malloc (*section_size);
-	  if (! *section_buffer)
-	    return FALSE;
-	  if (! bfd_get_section_contents (abfd, msec, *section_buffer,
-					  0, *section_size))
+	  void *map_addr;
+	  bfd_size_type map_len;
+
+	  if (! bfd_map_section_contents (abfd, msec, section_buffer,
+					  &map_addr, &map_len))
 	    return FALSE;
+	  if (map_addr != NULL)
+	    {
+	      struct section_map *map;
+
+	      map = (struct section_map *) bfd_malloc (sizeof (*map));
+	      if (map == NULL)
+		{
+		  bfd_unmap_section_contents (*section_buffer,
+					      map_addr, map_len);
+		  *section_buffer = NULL;
+		  return FALSE;
+		}
+	      map->buffer = *section_buffer;
+	      map->map_addr = map_addr;
+	      map->map_len = map_len;
+	      map->next = stash->section_maps;
+	      stash->section_maps = map;
+	    }
 	}
     }
 
@@ -677,7 +769,7 @@ read_indirect_string (struct comp_unit * unit,
 
   *bytes_read_ptr = unit->offset_size;
 
-  if (! read_section (unit->abfd, &stash->debug_sections[debug_str],
+  if (! read_section (unit->abfd, stash, &stash->debug_sections[debug_str],
 		      stash->syms, offset,
 		      &stash->dwarf_str_buffer, &stash->dwarf_str_size))
     return NULL;
@@ -738,7 +830,7 @@ read_alt_indirect_string (struct comp_unit * unit,
       stash->alt_bfd_ptr = debug_bfd;
     }
 
-  if (! read_section (unit->stash->alt_bfd_ptr,
+  if (! read_section (unit->stash->alt_bfd_ptr, stash,
 		      stash->debug_sections + debug_str_alt,
 		      NULL, /* FIXME: Do we need to load alternate symbols ?  */
 		      offset,
@@ -786,7 +878,7 @@ read_alt_indirect_ref (struct comp_unit * unit,
       stash->alt_bfd_ptr = debug_bfd;
     }
 
-  if (! read_section (unit->stash->alt_bfd_ptr,
+  if (! read_section (unit->stash->alt_bfd_ptr, stash,
 		      stash->debug_sections + debug_info_alt,
 		      NULL, /* FIXME: Do we need to load alternate symbols ?  */
 		      offset,
@@ -878,7 +970,7 @@ read_abbrevs (bfd *abfd, bfd_uint64_t offset, struct dwarf2_debug *stash)
   unsigned int abbrev_form, hash_number;
   bfd_size_type amt;
 
-  if (! read_section (abfd, &stash->debug_sections[debug_abbrev],
+  if (! read_section (abfd, stash, &stash->debug_sections[debug_abbrev],
 		      stash->syms, offset,
 		      &stash->dwarf_abbrev_buffer, &stash->dwarf_abbrev_size))
     return NULL;
@@ -1236,6 +1328,8 @@ struct line_sequence
   bfd_vma               low_pc;
   struct line_sequence* prev_sequence;
   struct line_info*     last_line;  /* Largest VMA.  */
+  struct line_info**    line_info_lookup;  /* Lines by ascending VMA.  */
+  unsigned int          num_lines;
 };
 
 struct line_info_table
@@ -1278,6 +1372,21 @@ struct funcinfo
   asection *sec;
 };
 
+/* An entry in a comp_unit's lookup_funcinfo_table.  */
+
+struct lookup_funcinfo
+{
+  /* One of the address ranges of FUNCINFO.  */
+  bfd_vma low;
+  bfd_vma high;
+  /* The largest HIGH of this and all preceding entries.  */
+  bfd_vma high_addr_max;
+  struct funcinfo *funcinfo;
+  /* Position of FUNCINFO in the function_table list.  Ties between
+     equally sized ranges go to the function nearest the list head.  */
+  bfd_size_type idx;
+};
+
 struct varinfo
 {
   /* Pointer to previous variable in list of all variables */
@@ -1386,6 +1495,8 @@ add_line_info (struct line_info_table *table,
       seq->low_pc = address;
       seq->prev_sequence = table->sequences;
       seq->last_line = info;
+      seq->line_info_lookup = NULL;
+      seq->num_lines = 0;
       table->lcl_head = info;
       table->sequences = seq;
       table->num_sequences++;
@@ -1549,6 +1660,24 @@ arange_add (const struct comp_unit *unit, struct arange *first_arange,
   return TRUE;
 }
 
+/* Note that the address ranges of UNIT, which has been linked into
+   its stash's list of comp_units, are no longer those recorded in the
+   stash's arange index.  */
+
+static void
+unindex_comp_unit (struct comp_unit *unit)
+{
+  struct dwarf2_debug *stash = unit->stash;
+
+  if (unit->arange_indexed)
+    {
+      unit->arange_indexed = FALSE;
+      unit->next_unindexed_unit = stash->unindexed_units;
+      stash->unindexed_units = unit;
+      stash->unindexed_unit_count++;
+    }
+}
+
 /* Compare function for line sequences.  */
 
 static int
@@ -1609,6 +1738,8 @@ sort_line_sequences (struct line_info_table* table)
       sequences[n].low_pc = seq->low_pc;
       sequences[n].prev_sequence = NULL;
       sequences[n].last_line = seq->last_line;
+      sequences[n].line_info_lookup = NULL;
+      sequences[n].num_lines = 0;
       seq = seq->prev_sequence;
       free (last_seq);
     }
@@ -1662,7 +1793,7 @@ decode_line_info (struct comp_unit *unit, struct dwarf2_debug *stash)
   unsigned int exop_len;
   bfd_size_type amt;
 
-  if (! read_section (abfd, &stash->debug_sections[debug_line],
+  if (! read_section (abfd, stash, &stash->debug_sections[debug_line],
 		      stash->syms, unit->line_offset,
 		      &stash->dwarf_line_buffer, &stash->dwarf_line_size))
     return NULL;
@@ -1926,6 +2057,7 @@ decode_line_info (struct comp_unit *unit, struct dwarf2_debug *stash)
 		    low_pc = address;
 		  if (address > high_pc)
 		    high_pc = address;
+		  unindex_comp_unit (unit);
 		  if (!arange_add (unit, &unit->arange, low_pc, high_pc))
 		    goto line_fail;
 		  break;
@@ -2081,6 +2213,53 @@ decode_line_info (struct comp_unit *unit, struct dwarf2_debug *stash)
    The parameters FILENAME_PTR, LINENUMBER_PTR and DISCRIMINATOR_PTR
    are pointers to the objects to be filled in.  */
 
+/* Build an array of the lines in SEQ sorted by ascending VMA, so that
+   a line can be found by binary search instead of walking the
+   descending prev_line list.  */
+
+static bfd_boolean
+build_line_info_table (struct line_info_table *table,
+		       struct line_sequence *seq)
+{
+  bfd_size_type amt;
+  struct line_info **line_info_lookup;
+  struct line_info *each_line;
+  unsigned int num_lines;
+  unsigned int line_index;
+
+  if (seq->line_info_lookup != NULL)
+    return TRUE;
+
+  /* Count the number of line information entries.  We could do this
+     while scanning the debug information, but some entries may be
+     added via lcl_head without having a sequence handy to increment
+     the number of lines.  */
+  num_lines = 0;
+  for (each_line = seq->last_line; each_line; each_line = each_line->prev_line)
+    num_lines++;
+
+  if (num_lines == 0)
+    return TRUE;
+
+  /* Allocate space for the line information lookup table.  */
+  amt = sizeof (struct line_info*) * num_lines;
+  line_info_lookup = (struct line_info**) bfd_alloc (table->abfd, amt);
+  if (line_info_lookup == NULL)
+    return FALSE;
+
+  /* Create the line information lookup table.  */
+  line_index = num_lines;
+  for (each_line = seq->last_line; each_line; each_line = each_line->prev_line)
+    line_info_lookup[--line_index] = each_line;
+
+  BFD_ASSERT (line_index == 0);
+
+  seq->num_lines = num_lines;
+  seq->line_info_lookup = line_info_lookup;
+
+  return TRUE;
+}
+
 static bfd_vma
 lookup_address_in_line_info_table (struct line_info_table *table,
 				   bfd_vma addr,
@@ -2109,12 +2288,28 @@ lookup_address_in_line_info_table (struct line_info_table *table,
 
   if (seq && addr >= seq->low_pc && addr < seq->last_line->address)
     {
-      /* Note: seq->last_line should be a descendingly sorted list.  */
-      for (each_line = seq->last_line;
-	   each_line;
-	   each_line = each_line->prev_line)
-	if (addr >= each_line->address)
-	  break;
+      if (!build_line_info_table (table, seq))
+	{
+	  *filename_ptr = NULL;
+	  return 0;
+	}
+
+      /* Binary search the array of lines for the last one at or below
+	 ADDR.  Where several lines share an address this picks the
+	 one nearest the head of the descending prev_line list.  */
+      each_line = NULL;
+      low = 0;
+      high = seq->num_lines;
+      while (low < high)
+	{
+	  mid = (low + high) / 2;
+	  if (addr < seq->line_info_lookup[mid]->address)
+	    high = mid;
+	  else
+	    low = mid + 1;
+	}
+      if (low > 0)
+	each_line = seq->line_info_lookup[low - 1];
 
       if (each_line
 	  && !(each_line->end_sequence || each_line == seq->last_line))
@@ -2137,7 +2332,8 @@ static bfd_boolean
 read_debug_ranges (struct comp_unit *unit)
 {
   struct dwarf2_debug *stash = unit->stash;
-  return read_section (unit->abfd, &stash->debug_sections[debug_ranges],
+  return read_section (unit->abfd, stash,
+		       &stash->debug_sections[debug_ranges],
 		       stash->syms, 0,
 		       &stash->dwarf_ranges_buffer, &stash->dwarf_ranges_size);
 }
@@ -2149,32 +2345,132 @@ read_debug_ranges (struct comp_unit *unit)
    that contains ADDR, to handle inlined functions without depending upon
    them being ordered in TABLE by increasing range.  */
 
+static int
+compare_lookup_funcinfos (const void *a, const void *b)
+{
+  const struct lookup_funcinfo *lookup1 = a;
+  const struct lookup_funcinfo *lookup2 = b;
+
+  if (lookup1->low < lookup2->low)
+    return -1;
+  if (lookup1->low > lookup2->low)
+    return 1;
+  if (lookup1->idx < lookup2->idx)
+    return -1;
+  if (lookup1->idx > lookup2->idx)
+    return 1;
+  return 0;
+}
+
+/* Build UNIT's lookup_funcinfo_table from its function_table.  */
+
+static bfd_boolean
+build_lookup_funcinfo_table (struct comp_unit *unit)
+{
+  struct lookup_funcinfo *lookup_funcinfo_table;
+  struct funcinfo *each_func;
+  struct arange *arange;
+  bfd_size_type number_of_aranges;
+  bfd_size_type func_index;
+  bfd_size_type n;
+  bfd_vma high_addr_max;
+
+  if (unit->lookup_funcinfo_table || unit->function_table == NULL)
+    return TRUE;
+
+  number_of_aranges = 0;
+  for (each_func = unit->function_table;
+       each_func;
+       each_func = each_func->prev_func)
+    for (arange = &each_func->arange; arange; arange = arange->next)
+      if (arange->low < arange->high)
+	number_of_aranges++;
+
+  if (number_of_aranges == 0)
+    return TRUE;
+
+  lookup_funcinfo_table = (struct lookup_funcinfo *)
+    bfd_alloc (unit->abfd, number_of_aranges * sizeof (*lookup_funcinfo_table));
+  if (lookup_funcinfo_table == NULL)
+    return FALSE;
+
+  n = 0;
+  func_index = 0;
+  for (each_func = unit->function_table;
+       each_func;
+       each_func = each_func->prev_func, func_index++)
+    for (arange = &each_func->arange; arange; arange = arange->next)
+      if (arange->low < arange->high)
+	{
+	  lookup_funcinfo_table[n].low = arange->low;
+	  lookup_funcinfo_table[n].high = arange->high;
+	  lookup_funcinfo_table[n].funcinfo = each_func;
+	  lookup_funcinfo_table[n].idx = func_index;
+	  n++;
+	}
+
+  qsort (lookup_funcinfo_table, number_of_aranges,
+	 sizeof (*lookup_funcinfo_table), compare_lookup_funcinfos);
+
+  high_addr_max = 0;
+  for (n = 0; n < number_of_aranges; n++)
+    {
+      if (lookup_funcinfo_table[n].high > high_addr_max)
+	high_addr_max = lookup_funcinfo_table[n].high;
+      lookup_funcinfo_table[n].high_addr_max = high_addr_max;
+    }
+
+  unit->lookup_funcinfo_table = lookup_funcinfo_table;
+  unit->number_of_function_aranges = number_of_aranges;
+  return TRUE;
+}
+
 static bfd_boolean
 lookup_address_in_function_table (struct comp_unit *unit,
 				  bfd_vma addr,
 				  struct funcinfo **function_ptr)
 {
-  struct funcinfo* each_func;
+  struct lookup_funcinfo *lookup_funcinfo;
   struct funcinfo* best_fit = NULL;
+  bfd_size_type best_fit_idx = 0;
   bfd_vma best_fit_len = 0;
-  struct arange *arange;
+  bfd_size_type low, high, mid;
 
-  for (each_func = unit->function_table;
-       each_func;
-       each_func = each_func->prev_func)
+  if (!build_lookup_funcinfo_table (unit)
+      || unit->number_of_function_aranges == 0)
+    return FALSE;
+
+  /* Find the first range starting above ADDR.  */
+  low = 0;
+  high = unit->number_of_function_aranges;
+  while (low < high)
     {
-      for (arange = &each_func->arange;
-	   arange;
-	   arange = arange->next)
+      mid = (low + high) / 2;
+      if (addr < unit->lookup_funcinfo_table[mid].low)
+	high = mid;
+      else
+	low = mid + 1;
+    }
+
+  /* Walk back over the ranges starting at or below ADDR while any of
+     them might still extend past it.  */
+  while (low > 0)
+    {
+      lookup_funcinfo = &unit->lookup_funcinfo_table[--low];
+      if (lookup_funcinfo->high_addr_max <= addr)
+	break;
+      if (addr < lookup_funcinfo->high)
 	{
-	  if (addr >= arange->low && addr < arange->high)
+	  bfd_vma len = lookup_funcinfo->high - lookup_funcinfo->low;
+
+	  if (!best_fit
+	      || len < best_fit_len
+	      || (len == best_fit_len
+		  && lookup_funcinfo->idx < best_fit_idx))
 	    {
-	      if (!best_fit
-		  || arange->high - arange->low < best_fit_len)
-		{
-		  best_fit = each_func;
-		  best_fit_len = arange->high - arange->low;
-		}
+	      best_fit = lookup_funcinfo->funcinfo;
+	      best_fit_idx = lookup_funcinfo->idx;
+	      best_fit_len = len;
 	    }
 	}
     }
@@ -2931,6 +3227,207 @@ comp_unit_contains_address (struct comp_unit *unit, bfd_vma addr)
   return FALSE;
 }
 
+static int
+compare_unit_aranges (const void *a, const void *b)
+{
+  const struct unit_arange *arange1 = a;
+  const struct unit_arange *arange2 = b;
+
+  if (arange1->low < arange2->low)
+    return -1;
+  if (arange1->low > arange2->low)
+    return 1;
+  if (arange1->unit->unit_number < arange2->unit->unit_number)
+    return -1;
+  if (arange1->unit->unit_number > arange2->unit->unit_number)
+    return 1;
+  return 0;
+}
+
+/* Rebuild STASH's arange index from all the comp_units read so far.  */
+
+static bfd_boolean
+build_unit_arange_index (struct dwarf2_debug *stash)
+{
+  struct comp_unit *each;
+  struct arange *arange;
+  struct unit_arange *unit_aranges;
+  struct comp_unit **unranged_units;
+  bfd_size_type arange_count = 0;
+  unsigned int unranged_count = 0;
+  bfd_size_type n;
+  bfd_vma high_addr_max;
+
+  for (each = stash->all_comp_units; each; each = each->next_unit)
+    if (each->arange.high == 0)
+      unranged_count++;
+    else
+      for (arange = &each->arange; arange; arange = arange->next)
+	if (arange->low < arange->high)
+	  arange_count++;
+
+  unit_aranges = (struct unit_arange *)
+    bfd_malloc ((arange_count + 1) * sizeof (*unit_aranges));
+  unranged_units = (struct comp_unit **)
+    bfd_malloc ((unranged_count + 1) * sizeof (*unranged_units));
+  if (unit_aranges == NULL || unranged_units == NULL)
+    {
+      free (unit_aranges);
+      free (unranged_units);
+      return FALSE;
+    }
+
+  arange_count = 0;
+  unranged_count = 0;
+  for (each = stash->all_comp_units; each; each = each->next_unit)
+    {
+      if (each->arange.high == 0)
+	unranged_units[unranged_count++] = each;
+      else
+	for (arange = &each->arange; arange; arange = arange->next)
+	  if (arange->low < arange->high)
+	    {
+	      unit_aranges[arange_count].low = arange->low;
+	      unit_aranges[arange_count].high = arange->high;
+	      unit_aranges[arange_count].unit = each;
+	      arange_count++;
+	    }
+      each->arange_indexed = TRUE;
+      each->next_unindexed_unit = NULL;
+    }
+
+  qsort (unit_aranges, arange_count, sizeof (*unit_aranges),
+	 compare_unit_aranges);
+
+  high_addr_max = 0;
+  for (n = 0; n < arange_count; n++)
+    {
+      if (unit_aranges[n].high > high_addr_max)
+	high_addr_max = unit_aranges[n].high;
+      unit_aranges[n].high_addr_max = high_addr_max;
+    }
+
+  free (stash->unit_aranges);
+  free (stash->unranged_units);
+  stash->unit_aranges = unit_aranges;
+  stash->unit_arange_count = arange_count;
+  stash->unranged_units = unranged_units;
+  stash->unranged_unit_count = unranged_count;
+  stash->unindexed_units = NULL;
+  stash->unindexed_unit_count = 0;
+  return TRUE;
+}
+
+/* Add UNIT to the units found by the current lookup in STASH, unless
+   it is already there.  */
+
+static bfd_boolean
+add_lookup_unit (struct dwarf2_debug *stash, struct comp_unit *unit,
+		 unsigned int *count)
+{
+  if (unit->lookup_mark == stash->lookup_mark)
+    return TRUE;
+  unit->lookup_mark = stash->lookup_mark;
+
+  if (*count >= stash->lookup_units_size)
+    {
+      unsigned int size = stash->lookup_units_size * 2 + 16;
+      struct comp_unit **units;
+
+      units = (struct comp_unit **)
+	bfd_realloc (stash->lookup_units, size * sizeof (*units));
+      if (units == NULL)
+	return FALSE;
+      stash->lookup_units = units;
+      stash->lookup_units_size = size;
+    }
+  stash->lookup_units[(*count)++] = unit;
+  return TRUE;
+}
+
+/* Find the comp_units read so far by STASH that may contain ADDR:
+   those with no address range and those with a range containing ADDR,
+   leaving out any that have had errors.  The units are stored in
+   STASH->lookup_units newest first, the order of the all_comp_units
+   list, and their number is returned in *COUNT.  */
+
+static bfd_boolean
+find_lookup_units (struct dwarf2_debug *stash, bfd_vma addr,
+		   unsigned int *count)
+{
+  struct comp_unit *each;
+  bfd_size_type low, high, mid;
+  unsigned int i, j;
+
+  *count = 0;
+  if (stash->unindexed_unit_count > STASH_UNINDEXED_UNITS_MAX
+      && !build_unit_arange_index (stash))
+    return FALSE;
+
+  if (++stash->lookup_mark == 0)
+    {
+      /* The mark has wrapped around; clear all the old ones.  */
+      for (each = stash->all_comp_units; each; each = each->next_unit)
+	each->lookup_mark = 0;
+      stash->lookup_mark = 1;
+    }
+
+  /* Find the first range starting above ADDR, then walk back over
+     those starting at or below it while any might extend past it.  */
+  low = 0;
+  high = stash->unit_arange_count;
+  while (low < high)
+    {
+      mid = (low + high) / 2;
+      if (addr < stash->unit_aranges[mid].low)
+	high = mid;
+      else
+	low = mid + 1;
+    }
+  while (low > 0)
+    {
+      struct unit_arange *unit_arange = &stash->unit_aranges[--low];
+
+      if (unit_arange->high_addr_max <= addr)
+	break;
+      each = unit_arange->unit;
+      if (addr < unit_arange->high
+	  && each->arange_indexed
+	  && !each->error
+	  && !add_lookup_unit (stash, each, count))
+	return FALSE;
+    }
+
+  for (i = 0; i < stash->unranged_unit_count; i++)
+    {
+      each = stash->unranged_units[i];
+      if (each->arange_indexed
+	  && !each->error
+	  && !add_lookup_unit (stash, each, count))
+	return FALSE;
+    }
+
+  for (each = stash->unindexed_units; each; each = each->next_unindexed_unit)
+    if ((each->arange.high == 0
+	 || comp_unit_contains_address (each, addr))
+	&& !each->error
+	&& !add_lookup_unit (stash, each, count))
+      return FALSE;
+
+  /* Sort newest first.  There are rarely more than a few.  */
+  for (i = 1; i < *count; i++)
+    {
+      each = stash->lookup_units[i];
+      for (j = i;
+	   j > 0 && stash->lookup_units[j - 1]->unit_number < each->unit_number;
+	   j--)
+	stash->lookup_units[j] = stash->lookup_units[j - 1];
+      stash->lookup_units[j] = each;
+    }
+
+  return TRUE;
+}
+
 /* If UNIT contains ADDR, set the output parameters to the values for
    the line containing ADDR.  The output parameters, FILENAME_PTR,
    FUNCTION_PTR, and LINENUMBER_PTR, are pointers to the objects
@@ -3744,7 +4241,8 @@ _bfd_dwarf2_slurp_debug_info (bfd *abfd, bfd *debug_bfd,
     {
       /* Case 1: only one info section.  */
       total_size = msec->size;
-      if (! read_section (debug_bfd, &stash->debug_sections[debug_info],
+      if (! read_section (debug_bfd, stash,
+			  &stash->debug_sections[debug_info],
 			  symbols, 0,
 			  &stash->info_ptr_memory, &total_size))
 	return FALSE;
@@ -3963,19 +4461,26 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
       struct funcinfo *local_function = NULL;
       unsigned int local_linenumber = 0;
       unsigned int local_discriminator = 0;
+      unsigned int lookup_count;
+      unsigned int i;
 
-      for (each = stash->all_comp_units; each; each = each->next_unit)
+      /* Rather than testing every unit read so far, look up the units
+	 that may contain ADDR in the arange index.  */
+      if (!find_lookup_units (stash, addr, &lookup_count))
+	return FALSE;
+
+      for (i = 0; i < lookup_count; i++)
 	{
-	  bfd_vma range = (bfd_vma) -1;
-
-	  found = ((each->arange.high == 0
-		    || comp_unit_contains_address (each, addr))
-		   && (range = comp_unit_find_nearest_line (each, addr,
-							    & local_filename,
-							    & local_function,
-							    & local_linenumber,
-							    & local_discriminator,
-							    stash)) != 0);
+	  bfd_vma range;
+
+	  each = stash->lookup_units[i];
+	  range = comp_unit_find_nearest_line (each, addr,
+					       & local_filename,
+					       & local_function,
+					       & local_linenumber,
+					       & local_discriminator,
+					       stash);
+	  found = range != 0;
 	  if (found)
 	    {
 	      /* PRs 15935 15994: Bogus debug information may have provided us
@@ -3985,8 +4490,8 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
 		 will tend to result in extra large address ranges rather than
 		 extra small ranges).
 
-		 This does mean that we scan through all of the CUs associated
-		 with the bfd each time this function is called.  But this does
+		 This does mean that we check all of the CUs containing the
+		 address each time this function is called.  But this does
 		 have the benefit of producing consistent results every time the
 		 function is called.  */
 	      if (range <= min_range)
@@ -4009,6 +4514,11 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
 	  found = TRUE;
 	  goto done;
 	}
+
+      /* FOUND reflects the oldest unit read, as if every unit had
+	 been tried in turn.  */
+      found = (found
+	       && stash->lookup_units[lookup_count - 1] == stash->last_comp_unit);
     }
 
   /* The DWARF2 spec says that the initial length field, and the
@@ -4090,6 +4600,11 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
 	  each->next_unit = stash->all_comp_units;
 	  stash->all_comp_units = each;
 
+	  each->unit_number = ++stash->comp_unit_count;
+	  each->next_unindexed_unit = stash->unindexed_units;
+	  stash->unindexed_units = each;
+	  stash->unindexed_unit_count++;
+
 	  /* DW_AT_low_pc and DW_AT_high_pc are optional for
 	     compilation units.  If we don't have them (i.e.,
 	     unit->high == 0), we need to consult the line info table
@@ -4173,6 +4688,30 @@ _bfd_dwarf2_find_inliner_info (bfd *abfd ATTRIBUTE_UNUSED,
   return FALSE;
 }
 
+/* Release BUFFER, a section buffer set up by read_section.  */
+
+static void
+free_section_buffer (struct dwarf2_debug *stash, bfd_byte *buffer)
+{
+  struct section_map **pmap;
+
+  if (buffer == NULL)
+    return;
+
+  for (pmap = &stash->section_maps; *pmap != NULL; pmap = &(*pmap)->next)
+    if ((*pmap)->buffer == buffer)
+      {
+	struct section_map *map = *pmap;
+
+	*pmap = map->next;
+	bfd_unmap_section_contents (buffer, map->map_addr, map->map_len);
+	free (map);
+	return;
+      }
+
+  free (buffer);
+}
+
 void
 _bfd_dwarf2_cleanup_debug_info (bfd *abfd, void **pinfo)
 {
@@ -4234,28 +4773,25 @@ _bfd_dwarf2_cleanup_debug_info (bfd *abfd, void **pinfo)
 	}
     }
 
-  if (stash->dwarf_abbrev_buffer)
-    free (stash->dwarf_abbrev_buffer);
-  if (stash->dwarf_line_buffer)
-    free (stash->dwarf_line_buffer);
-  if (stash->dwarf_str_buffer)
-    free (stash->dwarf_str_buffer);
-  if (stash->dwarf_ranges_buffer)
-    free (stash->dwarf_ranges_buffer);
-  if (stash->info_ptr_memory)
-    free (stash->info_ptr_memory);
+  free_section_buffer (stash, stash->dwarf_abbrev_buffer);
+  free_section_buffer (stash, stash->dwarf_line_buffer);
+  free_section_buffer (stash, stash->dwarf_str_buffer);
+  free_section_buffer (stash, stash->dwarf_ranges_buffer);
+  free_section_buffer (stash, stash->info_ptr_memory);
+  free_section_buffer (stash, stash->alt_dwarf_str_buffer);
+  free_section_buffer (stash, stash->alt_dwarf_info_buffer);
+  BFD_ASSERT (stash->section_maps == NULL);
   if (stash->close_on_cleanup)
     bfd_close (stash->bfd_ptr);
-  if (stash->alt_dwarf_str_buffer)
-    free (stash->alt_dwarf_str_buffer);
-  if (stash->alt_dwarf_info_buffer)
-    free (stash->alt_dwarf_info_buffer);
   if (stash->sec_vma)
     free (stash->sec_vma);
   if (stash->adjusted_sections)
     free (stash->adjusted_sections);
   if (stash->alt_bfd_ptr)
     bfd_close (stash->alt_bfd_ptr);
+  free (stash->unit_aranges);
+  free (stash->unranged_units);
+  free (stash->lookup_units);
 }
 
 /* Find the function to a particular section and offset,
@@ -529,6 +529,12 @@ struct elf_link_hash_table
   /* A linked list of BFD's loaded in the link.  */
   struct elf_link_loaded_list *loaded;
 
+  /* Sections marked during --gc-sections whose relocations have yet
+     to be scanned.  */
+  asection **gc_mark_stack;
+  bfd_size_type gc_mark_stack_count;
+  bfd_size_type gc_mark_stack_size;
+
   /* Short-cuts to get to dynamic linker sections.  */
   asection *sgot;
   asection *sgotplt;
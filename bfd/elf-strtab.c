@@ -108,6 +108,10 @@ _bfd_elf_strtab_init (void)
       return NULL;
     }
 
+  /* Strings are written out in the order they were added, not in
+     hash table order.  */
+  table->table.word_hash = 1;
+
   table->sec_size = 0;
   table->size = 1;
   table->alloced = 64;
@@ -285,28 +289,112 @@ _bfd_elf_strtab_emit (register bfd *abfd, struct elf_strtab_hash *tab)
   return TRUE;
 }
 
-/* Compare two elf_strtab_hash_entry structures.  Called via qsort.  */
+/* Return one more than the character DEPTH places before the end of
+   the string in E, or zero if the string is no longer than DEPTH.  */
+
+static inline int
+strrevchar (const struct elf_strtab_hash_entry *e, int depth)
+{
+  if (depth >= e->len)
+    return 0;
+  return ((const unsigned char *) e->root.string)[e->len - 1 - depth] + 1;
+}
+
+/* Compare the strings in two elf_strtab_hash_entry structures
+   backwards, starting DEPTH characters from their ends.  A string
+   sorts before any longer string of which it is a suffix.  */
 
 static int
-strrevcmp (const void *a, const void *b)
+strrevcmp (const struct elf_strtab_hash_entry *A,
+	   const struct elf_strtab_hash_entry *B, int depth)
+{
+  for (;; depth++)
+    {
+      int a = strrevchar (A, depth);
+      int b = strrevchar (B, depth);
+
+      if (a != b)
+	return a - b;
+      if (a == 0)
+	return 0;
+    }
+}
+
+/* Sort the N entries in ARRAY, whose strings all end in the same
+   DEPTH characters, into strrevcmp order.  This is a multikey
+   quicksort: each partitioning step looks at a single character of
+   each string, so common suffixes are not compared over and over
+   again as they would be by qsort.  */
+
+static void
+strrevsort (struct elf_strtab_hash_entry **array, size_t n, int depth)
 {
-  struct elf_strtab_hash_entry *A = *(struct elf_strtab_hash_entry **) a;
-  struct elf_strtab_hash_entry *B = *(struct elf_strtab_hash_entry **) b;
-  unsigned int lenA = A->len;
-  unsigned int lenB = B->len;
-  const unsigned char *s = (const unsigned char *) A->root.string + lenA - 1;
-  const unsigned char *t = (const unsigned char *) B->root.string + lenB - 1;
-  int l = lenA < lenB ? lenA : lenB;
-
-  while (l)
+  struct elf_strtab_hash_entry *tmp;
+
+  while (n > 1)
     {
-      if (*s != *t)
-	return (int) *s - (int) *t;
-      s--;
-      t--;
-      l--;
+      size_t lt, gt, i;
+      int pivot, a, b, c;
+
+      if (n < 8)
+	{
+	  for (i = 1; i < n; i++)
+	    for (lt = i;
+		 lt > 0 && strrevcmp (array[lt - 1], array[lt], depth) > 0;
+		 lt--)
+	      {
+		tmp = array[lt];
+		array[lt] = array[lt - 1];
+		array[lt - 1] = tmp;
+	      }
+	  return;
+	}
+
+      /* Partition around the median of three characters into those
+	 less than, equal to and greater than the pivot.  */
+      a = strrevchar (array[0], depth);
+      b = strrevchar (array[n / 2], depth);
+      if (a > b)
+	{
+	  c = a;
+	  a = b;
+	  b = c;
+	}
+      c = strrevchar (array[n - 1], depth);
+      pivot = c < a ? a : c > b ? b : c;
+
+      lt = 0;
+      gt = n;
+      i = 0;
+      while (i < gt)
+	{
+	  c = strrevchar (array[i], depth);
+	  if (c < pivot)
+	    {
+	      tmp = array[lt];
+	      array[lt++] = array[i];
+	      array[i++] = tmp;
+	    }
+	  else if (c > pivot)
+	    {
+	      tmp = array[--gt];
+	      array[gt] = array[i];
+	      array[i] = tmp;
+	    }
+	  else
+	    i++;
+	}
+
+      strrevsort (array, lt, depth);
+      strrevsort (array + gt, n - gt, depth);
+
+      /* The strings are distinct, so only one can end here.  */
+      if (pivot == 0)
+	return;
+      array += lt;
+      n = gt - lt;
+      depth++;
     }
-  return lenA - lenB;
 }
 
 static inline int
@@ -359,7 +447,7 @@ _bfd_elf_strtab_finalize (struct elf_strtab_hash *tab)
   size = a - array;
   if (size != 0)
     {
-      qsort (array, size, sizeof (struct elf_strtab_hash_entry *), strrevcmp);
+      strrevsort (array, size, 0);
 
       /* Loop over the sorted array and merge suffixes.  Start from the
 	 end because we want eg.
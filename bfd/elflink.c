@@ -4932,6 +4932,138 @@ _bfd_elf_archive_symbol_lookup (bfd *abfd,
   return h;
 }
 
+/* Per armap entry flags used by elf_link_add_archive_symbols.  */
+
+/* The symbol is known to be defined, or its archive member has been
+   included.  Don't check it again.  */
+#define ARMAP_DONE	1
+
+/* The symbol needs to be looked up on the next visit, either because
+   it was undefined weak or common last time, or because a symbol
+   that it might resolve has since been added to the undefs list.  */
+#define ARMAP_PENDING	2
+
+/* An index of the archive map by symbol name, so that a new undefined
+   symbol can be matched against the armap entries which might define
+   it without looking up every armap entry again.  */
+
+struct elf_armap_index
+{
+  /* The head of each hash chain, or BFD_NO_MORE_SYMBOLS.  */
+  symindex *buckets;
+  /* The next armap entry in the same chain.  */
+  symindex *chain;
+  /* The hash of each armap entry's name.  */
+  unsigned long *hashes;
+  /* The number of buckets, minus one.  */
+  unsigned long mask;
+};
+
+/* Hash NAME for an elf_armap_index.  Any version suffix and a leading
+   dot are ignored, so that the name of every hash table entry that
+   elf_backend_archive_symbol_lookup might return for an armap symbol
+   hashes to the same value as the armap symbol itself.  */
+
+static unsigned long
+elf_armap_hash (const char *name)
+{
+  const unsigned char *s = (const unsigned char *) name;
+  unsigned long hash = 0;
+
+  if (*s == '.')
+    s++;
+  for (; *s != '\0' && *s != ELF_VER_CHR; s++)
+    hash = hash * 31 + *s;
+  return hash;
+}
+
+/* Build the name index ARMAP for the C entries of SYMDEFS.  */
+
+static bfd_boolean
+elf_armap_index_init (struct elf_armap_index *armap,
+		      carsym *symdefs, symindex c)
+{
+  bfd_size_type amt;
+  unsigned long nbuckets;
+  symindex i;
+
+  nbuckets = 64;
+  while (nbuckets < c)
+    nbuckets <<= 1;
+
+  amt = nbuckets * sizeof (*armap->buckets);
+  armap->buckets = (symindex *) bfd_malloc (amt);
+  amt = c * sizeof (*armap->chain);
+  armap->chain = (symindex *) bfd_malloc (amt);
+  amt = c * sizeof (*armap->hashes);
+  armap->hashes = (unsigned long *) bfd_malloc (amt);
+  if (armap->buckets == NULL
+      || armap->chain == NULL
+      || armap->hashes == NULL)
+    return FALSE;
+
+  armap->mask = nbuckets - 1;
+  memset (armap->buckets, 0xff, nbuckets * sizeof (*armap->buckets));
+  for (i = c; i-- > 0; )
+    {
+      unsigned long hash = elf_armap_hash (symdefs[i].name);
+
+      armap->hashes[i] = hash;
+      armap->chain[i] = armap->buckets[hash & armap->mask];
+      armap->buckets[hash & armap->mask] = i;
+    }
+  return TRUE;
+}
+
+static void
+elf_armap_index_free (struct elf_armap_index *armap)
+{
+  if (armap->buckets != NULL)
+    free (armap->buckets);
+  if (armap->chain != NULL)
+    free (armap->chain);
+  if (armap->hashes != NULL)
+    free (armap->hashes);
+}
+
+/* Mark as pending every armap entry which might resolve a symbol added
+   to the undefs list of INFO since *SEEN, and update *SEEN.  If the
+   undefs list has been rearranged so that the new entries can't be
+   found, mark every entry which is not yet done.  */
+
+static void
+elf_armap_mark_new_undefs (struct bfd_link_info *info,
+			   struct elf_armap_index *armap,
+			   unsigned char *flags, symindex c,
+			   struct bfd_link_hash_entry **seen)
+{
+  struct bfd_link_hash_entry *h, *last;
+  symindex i;
+
+  last = *seen;
+  h = last != NULL ? last->u.undef.next : info->hash->undefs;
+  for (; h != NULL; h = h->u.undef.next)
+    {
+      unsigned long hash = elf_armap_hash (h->root.string);
+
+      for (i = armap->buckets[hash & armap->mask];
+	   i != BFD_NO_MORE_SYMBOLS;
+	   i = armap->chain[i])
+	if (armap->hashes[i] == hash && (flags[i] & ARMAP_DONE) == 0)
+	  flags[i] |= ARMAP_PENDING;
+      last = h;
+    }
+
+  if (last != info->hash->undefs_tail)
+    {
+      for (i = 0; i < c; i++)
+	if ((flags[i] & ARMAP_DONE) == 0)
+	  flags[i] |= ARMAP_PENDING;
+      last = info->hash->undefs_tail;
+    }
+  *seen = last;
+}
+
 /* Add symbols from an ELF archive file to the linker hash table.  We
    don't use _bfd_generic_link_add_archive_symbols because we need to
    handle versioned symbols.
@@ -4943,19 +5075,26 @@ _bfd_elf_archive_symbol_lookup (bfd *abfd,
    object file.
 
    Unfortunately, we do have to make multiple passes over the symbol
-   table until nothing further is resolved.  */
+   table until nothing further is resolved.  The first pass looks up
+   every symbol in the archive map.  Later passes only look up those
+   which were undefined weak or common, and those which might resolve
+   a symbol that became undefined after they were last looked up, so
+   members are still included in the same order as a full rescan
+   would include them.  */
 
 static bfd_boolean
 elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
 {
   symindex c;
-  unsigned char *included = NULL;
+  unsigned char *flags = NULL;
   carsym *symdefs;
   bfd_boolean loop;
   bfd_size_type amt;
   const struct elf_backend_data *bed;
   struct elf_link_hash_entry * (*archive_symbol_lookup)
     (bfd *, struct bfd_link_info *, const char *);
+  struct elf_armap_index armap;
+  struct bfd_link_hash_entry *undefs_seen;
 
   if (! bfd_has_map (abfd))
     {
@@ -4973,24 +5112,28 @@ elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
   if (c == 0)
     return TRUE;
   amt = c;
-  amt *= sizeof (*included);
-  included = (unsigned char *) bfd_zmalloc (amt);
-  if (included == NULL)
+  amt *= sizeof (*flags);
+  flags = (unsigned char *) bfd_malloc (amt);
+  if (flags == NULL)
     return FALSE;
+  memset (flags, ARMAP_PENDING, amt);
 
   symdefs = bfd_ardata (abfd)->symdefs;
   bed = get_elf_backend_data (abfd);
   archive_symbol_lookup = bed->elf_backend_archive_symbol_lookup;
 
+  /* The armap is only indexed once some member adds new undefined
+     symbols.  */
+  memset (&armap, 0, sizeof (armap));
+  undefs_seen = info->hash->undefs_tail;
+
   do
     {
-      file_ptr last;
       symindex i;
       carsym *symdef;
       carsym *symdefend;
 
       loop = FALSE;
-      last = -1;
 
       symdef = symdefs;
       symdefend = symdef + c;
@@ -5001,13 +5144,9 @@ elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
 	  struct bfd_link_hash_entry *undefs_tail;
 	  symindex mark;
 
-	  if (included[i])
+	  if ((flags[i] & ARMAP_PENDING) == 0)
 	    continue;
-	  if (symdef->file_offset == last)
-	    {
-	      included[i] = TRUE;
-	      continue;
-	    }
+	  flags[i] &= ~ARMAP_PENDING;
 
 	  h = archive_symbol_lookup (abfd, info, symdef->name);
 	  if (h == (struct elf_link_hash_entry *) 0 - 1)
@@ -5031,13 +5170,18 @@ elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
 		 table and check that to see what kind of symbol definition
 		 this is.  */
 	      if (! elf_link_is_defined_archive_symbol (abfd, symdef))
-		continue;
+		{
+		  flags[i] |= ARMAP_PENDING;
+		  continue;
+		}
 	    }
 	  else if (h->root.type != bfd_link_hash_undefined)
 	    {
 	      if (h->root.type != bfd_link_hash_undefweak)
 		/* Symbol must be defined.  Don't check it again.  */
-		included[i] = TRUE;
+		flags[i] = ARMAP_DONE;
+	      else
+		flags[i] |= ARMAP_PENDING;
 	      continue;
 	    }
 
@@ -5057,42 +5201,54 @@ elf_link_add_archive_symbols (bfd *abfd, struct bfd_link_info *info)
 	  if (!bfd_link_add_symbols (element, info))
 	    goto error_return;
 
-	  /* If there are any new undefined symbols, we need to make
-	     another pass through the archive in order to see whether
-	     they can be defined.  FIXME: This isn't perfect, because
-	     common symbols wind up on undefs_tail and because an
-	     undefined symbol which is defined later on in this pass
-	     does not require another pass.  This isn't a bug, but it
-	     does make the code less efficient than it could be.  */
-	  if (undefs_tail != info->hash->undefs_tail)
-	    loop = TRUE;
-
-	  /* Look backward to mark all symbols from this object file
-	     which we have already seen in this pass.  */
+	  /* Mark all symbols from this object file which are adjacent
+	     to this one in the armap.  */
 	  mark = i;
 	  do
 	    {
-	      included[mark] = TRUE;
+	      flags[mark] = ARMAP_DONE;
 	      if (mark == 0)
 		break;
 	      --mark;
 	    }
 	  while (symdefs[mark].file_offset == symdef->file_offset);
+	  for (mark = i + 1;
+	       mark < c && symdefs[mark].file_offset == symdef->file_offset;
+	       mark++)
+	    flags[mark] = ARMAP_DONE;
 
-	  /* We mark subsequent symbols from this object file as we go
-	     on through the loop.  */
-	  last = symdef->file_offset;
+	  /* If there are any new undefined symbols, we need to make
+	     another pass through the archive in order to see whether
+	     they can be defined.  Only the armap entries which might
+	     define them need to be looked at again; those later in
+	     the armap are looked at in this pass.  FIXME: This isn't
+	     perfect, because common symbols wind up on undefs_tail and
+	     because an undefined symbol which is defined later on in
+	     this pass does not require another pass.  This isn't a
+	     bug, but it does make the code less efficient than it could
+	     be.  */
+	  if (undefs_tail != info->hash->undefs_tail)
+	    {
+	      loop = TRUE;
+	      if (armap.buckets == NULL
+		  && !elf_armap_index_init (&armap, symdefs, c))
+		goto error_return;
+	      elf_armap_mark_new_undefs (info, &armap, flags, c,
+					 &undefs_seen);
+	    }
 	}
     }
   while (loop);
 
-  free (included);
+  elf_armap_index_free (&armap);
+  free (flags);
 
   return TRUE;
 
  error_return:
-  if (included != NULL)
-    free (included);
+  elf_armap_index_free (&armap);
+  if (flags != NULL)
+    free (flags);
   return FALSE;
 }
 
@@ -6841,6 +6997,9 @@ _bfd_elf_link_hash_table_init
   table->init_plt_offset.offset = -(bfd_vma) 1;
   /* The first dynamic symbol is a dummy.  */
   table->dynsymcount = 1;
+  table->gc_mark_stack = NULL;
+  table->gc_mark_stack_count = 0;
+  table->gc_mark_stack_size = 0;
 
   ret = _bfd_link_hash_table_init (&table->root, abfd, newfunc, entsize);
 
@@ -9592,6 +9751,8 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
   for (o = input_bfd->sections; o != NULL; o = o->next)
     {
       bfd_byte *contents;
+      void *map_addr = NULL;
+      bfd_size_type map_len = 0;
 
       if (! o->linker_mark)
 	{
@@ -9689,6 +9850,18 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	      contents = flinfo->contents;
 	    }
 	}
+      else if ((o->flags & (SEC_RELOC | SEC_ELF_REVERSE_COPY)) == 0
+	       && o->rawsize == 0
+	       && o->sec_info_type == SEC_INFO_TYPE_NONE
+	       && bed->elf_backend_write_section == NULL)
+	{
+	  /* The contents are copied verbatim to the output file, so
+	     a read-only view of the input file will do.  */
+	  contents = flinfo->contents;
+	  if (! bfd_map_section_contents (input_bfd, o, &contents,
+					  &map_addr, &map_len))
+	    return FALSE;
+	}
       else
 	{
 	  contents = flinfo->contents;
@@ -10212,6 +10385,9 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	  }
 	  break;
 	}
+
+      if (map_addr != NULL)
+	bfd_unmap_section_contents (contents, map_addr, map_len);
     }
 
   return TRUE;
@@ -11870,9 +12046,38 @@ _bfd_elf_gc_mark_rsec (struct bfd_link_info *info, asection *sec,
 			  &cookie->locsyms[r_symndx]);
 }
 
+/* Add SEC, which the mark phase of garbage collection has decided to
+   keep, to the stack of sections whose relocations are still to be
+   scanned.  */
+
+static bfd_boolean
+elf_gc_push_section (struct bfd_link_info *info, asection *sec)
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+
+  sec->gc_mark = 1;
+  if (htab->gc_mark_stack_count >= htab->gc_mark_stack_size)
+    {
+      bfd_size_type size = htab->gc_mark_stack_size * 2;
+      asection **stack;
+
+      if (size == 0)
+	size = 64;
+      stack = (asection **) bfd_realloc (htab->gc_mark_stack,
+					 size * sizeof (*stack));
+      if (stack == NULL)
+	return FALSE;
+      htab->gc_mark_stack = stack;
+      htab->gc_mark_stack_size = size;
+    }
+  htab->gc_mark_stack[htab->gc_mark_stack_count++] = sec;
+  return TRUE;
+}
+
 /* COOKIE->rel describes a relocation against section SEC, which is
    a section we've decided to keep.  Mark the section that contains
-   the relocation symbol.  */
+   the relocation symbol.  ELF sections are only queued here; their
+   own relocations are scanned by the enclosing _bfd_elf_gc_mark.  */
 
 bfd_boolean
 _bfd_elf_gc_mark_reloc (struct bfd_link_info *info,
@@ -11888,30 +12093,27 @@ _bfd_elf_gc_mark_reloc (struct bfd_link_info *info,
       if (bfd_get_flavour (rsec->owner) != bfd_target_elf_flavour
 	  || (rsec->owner->flags & DYNAMIC) != 0)
 	rsec->gc_mark = 1;
-      else if (!_bfd_elf_gc_mark (info, rsec, gc_mark_hook))
+      else if (!elf_gc_push_section (info, rsec))
 	return FALSE;
     }
   return TRUE;
 }
 
-/* The mark phase of garbage collection.  For a given section, mark
-   it and any sections in this section's group, and all the sections
-   which define symbols to which it refers.  */
+/* Queue the rest of SEC's group, and all the sections which define
+   symbols to which SEC or its FDEs refer.  SEC is already marked.  */
 
-bfd_boolean
-_bfd_elf_gc_mark (struct bfd_link_info *info,
-		  asection *sec,
-		  elf_gc_mark_hook_fn gc_mark_hook)
+static bfd_boolean
+elf_gc_mark_section_refs (struct bfd_link_info *info,
+			  asection *sec,
+			  elf_gc_mark_hook_fn gc_mark_hook)
 {
   bfd_boolean ret;
   asection *group_sec, *eh_frame;
 
-  sec->gc_mark = 1;
-
   /* Mark all the sections in the group.  */
   group_sec = elf_section_data (sec)->next_in_group;
   if (group_sec && !group_sec->gc_mark)
-    if (!_bfd_elf_gc_mark (info, group_sec, gc_mark_hook))
+    if (!elf_gc_push_section (info, group_sec))
       return FALSE;
 
   /* Look through the section relocs.  */
@@ -11955,6 +12157,42 @@ _bfd_elf_gc_mark (struct bfd_link_info *info,
   return ret;
 }
 
+/* The mark phase of garbage collection.  For a given section, mark
+   it and any sections in this section's group, and all the sections
+   which define symbols to which it refers.  Rather than recursing,
+   newly marked sections are pushed on a stack which is drained here,
+   so that long reference chains do not exhaust the C stack.  */
+
+bfd_boolean
+_bfd_elf_gc_mark (struct bfd_link_info *info,
+		  asection *sec,
+		  elf_gc_mark_hook_fn gc_mark_hook)
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  bfd_size_type base = htab->gc_mark_stack_count;
+  bfd_boolean ret = TRUE;
+
+  if (!elf_gc_push_section (info, sec))
+    ret = FALSE;
+
+  while (ret && htab->gc_mark_stack_count > base)
+    {
+      asection *isec = htab->gc_mark_stack[--htab->gc_mark_stack_count];
+
+      if (!elf_gc_mark_section_refs (info, isec, gc_mark_hook))
+	ret = FALSE;
+    }
+
+  htab->gc_mark_stack_count = base;
+  if (base == 0)
+    {
+      free (htab->gc_mark_stack);
+      htab->gc_mark_stack = NULL;
+      htab->gc_mark_stack_size = 0;
+    }
+  return ret;
+}
+
 /* Keep debug and special sections.  */
 
 bfd_boolean
@@ -24,6 +24,7 @@
 #include "libbfd.h"
 #include "objalloc.h"
 #include "libiberty.h"
+#include "hashtab.h"
 
 /*
 SECTION
@@ -401,6 +402,7 @@ bfd_hash_table_init_n (struct bfd_hash_table *table,
   table->entsize = entsize;
   table->count = 0;
   table->frozen = 0;
+  table->word_hash = 0;
   table->newfunc = newfunc;
   return TRUE;
 }
@@ -451,6 +453,28 @@ bfd_hash_hash (const char *string, unsigned int *lenp)
   return hash;
 }
 
+/* Hash STRING for TABLE, storing its length in *LENP if LENP is not
+   NULL.  The output of many linker hash table traversals depends on
+   the bucket order, so bfd_hash_hash stays the default.  Tables which
+   ask for it get libiberty's iterative_hash, which mixes twelve bytes
+   at a time after a (word-at-a-time) strlen, and is much cheaper for
+   long symbol names.  */
+
+static inline unsigned long
+bfd_hash_table_hash (struct bfd_hash_table *table, const char *string,
+		     unsigned int *lenp)
+{
+  unsigned int len;
+
+  if (!table->word_hash)
+    return bfd_hash_hash (string, lenp);
+
+  len = strlen (string);
+  if (lenp != NULL)
+    *lenp = len;
+  return iterative_hash (string, len, len);
+}
+
 /* Look up a string in a hash table.  */
 
 struct bfd_hash_entry *
@@ -464,7 +488,7 @@ bfd_hash_lookup (struct bfd_hash_table *table,
   unsigned int len;
   unsigned int _index;
 
-  hash = bfd_hash_hash (string, &len);
+  hash = bfd_hash_table_hash (table, string, &len);
   _index = hash % table->size;
   for (hashp = table->table[_index];
        hashp != NULL;
@@ -580,7 +604,7 @@ bfd_hash_rename (struct bfd_hash_table *table,
 
   *pph = ent->next;
   ent->string = string;
-  ent->hash = bfd_hash_hash (string, NULL);
+  ent->hash = bfd_hash_table_hash (table, string, NULL);
   _index = ent->hash % table->size;
   ent->next = table->table[_index];
   table->table[_index] = ent;
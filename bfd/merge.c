@@ -81,6 +81,15 @@ struct sec_merge_info
   struct sec_merge_hash *htab;
 };
 
+/* An entity recorded from a SEC_MERGE section, by its offset in the
+   original section contents.  */
+
+struct sec_merge_sec_ofs
+{
+  bfd_size_type offset;
+  struct sec_merge_hash_entry *entry;
+};
+
 struct sec_merge_sec_info
 {
   /* Chain of sec_merge_sec_infos.  */
@@ -93,6 +102,11 @@ struct sec_merge_sec_info
   struct sec_merge_hash *htab;
   /* First string in this section.  */
   struct sec_merge_hash_entry *first_str;
+  /* The entities recorded from this section in ascending offset
+     order, so that _bfd_merged_section_offset can find them without
+     hashing the contents again.  */
+  struct sec_merge_sec_ofs *ofs_map;
+  bfd_size_type ofs_count;
   /* Original section content.  */
   unsigned char contents[1];
 };
@@ -149,13 +163,12 @@ sec_merge_hash_lookup (struct sec_merge_hash *table, const char *string,
     {
       if (table->entsize == 1)
 	{
-	  while ((c = *s++) != '\0')
-	    {
-	      hash += c + (c << 17);
-	      hash ^= hash >> 2;
-	      ++len;
-	    }
-	  hash += len + (len << 17);
+	  /* Entries are output in the order they were added, so the
+	     hash function only matters for speed.  Hash a word at a
+	     time; this is the common case for .debug_str and
+	     .rodata.str sections.  */
+	  len = strlen (string);
+	  hash = iterative_hash (string, len, len);
 	}
       else
 	{
@@ -428,6 +441,8 @@ _bfd_add_merge_section (bfd *abfd, void **psinfo, asection *sec,
   secinfo->psecinfo = psecinfo;
   secinfo->htab = sinfo->htab;
   secinfo->first_str = NULL;
+  secinfo->ofs_map = NULL;
+  secinfo->ofs_count = 0;
 
   sec->rawsize = sec->size;
   if (sec->flags & SEC_STRINGS)
@@ -443,6 +458,39 @@ _bfd_add_merge_section (bfd *abfd, void **psinfo, asection *sec,
   return FALSE;
 }
 
+/* Add the entity at P in SECINFO's contents to the hash table, and
+   note it in the growing offset map *PMAP, of *PSIZE entries.  */
+
+static struct sec_merge_hash_entry *
+record_entity (struct sec_merge_info *sinfo,
+	       struct sec_merge_sec_info *secinfo, unsigned char *p,
+	       unsigned int alignment, struct sec_merge_sec_ofs **pmap,
+	       bfd_size_type *psize)
+{
+  struct sec_merge_hash_entry *entry;
+
+  entry = sec_merge_add (sinfo->htab, (char *) p, alignment, secinfo);
+  if (entry == NULL)
+    return NULL;
+
+  if (secinfo->ofs_count >= *psize)
+    {
+      bfd_size_type size = *psize * 2 + 64;
+      struct sec_merge_sec_ofs *map;
+
+      map = (struct sec_merge_sec_ofs *) bfd_realloc (*pmap,
+						      size * sizeof (*map));
+      if (map == NULL)
+	return NULL;
+      *pmap = map;
+      *psize = size;
+    }
+  (*pmap)[secinfo->ofs_count].offset = p - secinfo->contents;
+  (*pmap)[secinfo->ofs_count].entry = entry;
+  secinfo->ofs_count++;
+  return entry;
+}
+
 /* Record one section into the hash table.  */
 static bfd_boolean
 record_section (struct sec_merge_info *sinfo,
@@ -450,11 +498,14 @@ record_section (struct sec_merge_info *sinfo,
 {
   asection *sec = secinfo->sec;
   struct sec_merge_hash_entry *entry;
+  struct sec_merge_sec_ofs *map = NULL;
+  bfd_size_type map_size = 0;
   bfd_boolean nul;
   unsigned char *p, *end;
   bfd_vma mask, eltalign;
   unsigned int align, i;
 
+  secinfo->ofs_count = 0;
   align = sec->alignment_power;
   end = secinfo->contents + sec->size;
   nul = FALSE;
@@ -467,8 +518,8 @@ record_section (struct sec_merge_info *sinfo,
 	  eltalign = ((eltalign ^ (eltalign - 1)) + 1) >> 1;
 	  if (!eltalign || eltalign > mask)
 	    eltalign = mask + 1;
-	  entry = sec_merge_add (sinfo->htab, (char *) p, (unsigned) eltalign,
-				 secinfo);
+	  entry = record_entity (sinfo, secinfo, p, (unsigned) eltalign,
+				 &map, &map_size);
 	  if (! entry)
 	    goto error_return;
 	  p += entry->len;
@@ -479,8 +530,9 @@ record_section (struct sec_merge_info *sinfo,
 		  if (!nul && !((p - secinfo->contents) & mask))
 		    {
 		      nul = TRUE;
-		      entry = sec_merge_add (sinfo->htab, "",
-					     (unsigned) mask + 1, secinfo);
+		      entry = record_entity (sinfo, secinfo, p,
+					     (unsigned) mask + 1,
+					     &map, &map_size);
 		      if (! entry)
 			goto error_return;
 		    }
@@ -499,8 +551,9 @@ record_section (struct sec_merge_info *sinfo,
 		  if (!nul && !((p - secinfo->contents) & mask))
 		    {
 		      nul = TRUE;
-		      entry = sec_merge_add (sinfo->htab, (char *) p,
-					     (unsigned) mask + 1, secinfo);
+		      entry = record_entity (sinfo, secinfo, p,
+					     (unsigned) mask + 1,
+					     &map, &map_size);
 		      if (! entry)
 			goto error_return;
 		    }
@@ -513,69 +566,183 @@ record_section (struct sec_merge_info *sinfo,
     {
       for (p = secinfo->contents; p < end; p += sec->entsize)
 	{
-	  entry = sec_merge_add (sinfo->htab, (char *) p, 1, secinfo);
+	  entry = record_entity (sinfo, secinfo, p, 1, &map, &map_size);
 	  if (! entry)
 	    goto error_return;
 	}
     }
 
+  /* Keep the offset map with the section contents.  */
+  if (secinfo->ofs_count != 0)
+    {
+      bfd_size_type amt = secinfo->ofs_count * sizeof (*map);
+
+      secinfo->ofs_map = (struct sec_merge_sec_ofs *)
+	bfd_alloc (sec->owner, amt);
+      if (secinfo->ofs_map == NULL)
+	goto error_return;
+      memcpy (secinfo->ofs_map, map, amt);
+    }
+  free (map);
   return TRUE;
 
 error_return:
+  free (map);
   for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
     *secinfo->psecinfo = NULL;
   return FALSE;
 }
 
-static int
-strrevcmp (const void *a, const void *b)
+/* Return the entity recorded from SECINFO's original contents that
+   covers OFFSET, and set *PSTART to its start, or return NULL if there
+   is none or it has since been superseded by a more aligned copy.  */
+
+static struct sec_merge_hash_entry *
+lookup_recorded_entity (struct sec_merge_sec_info *secinfo,
+			bfd_size_type offset, unsigned char **pstart)
 {
-  struct sec_merge_hash_entry *A = *(struct sec_merge_hash_entry **) a;
-  struct sec_merge_hash_entry *B = *(struct sec_merge_hash_entry **) b;
-  unsigned int lenA = A->len;
-  unsigned int lenB = B->len;
-  const unsigned char *s = (const unsigned char *) A->root.string + lenA - 1;
-  const unsigned char *t = (const unsigned char *) B->root.string + lenB - 1;
-  int l = lenA < lenB ? lenA : lenB;
-
-  while (l)
+  struct sec_merge_sec_ofs *ofs;
+  bfd_size_type lo, hi, mid;
+
+  /* Find the last entity starting at or below OFFSET.  */
+  lo = 0;
+  hi = secinfo->ofs_count;
+  while (lo < hi)
     {
-      if (*s != *t)
-	return (int) *s - (int) *t;
-      s--;
-      t--;
-      l--;
+      mid = (lo + hi) / 2;
+      if (offset < secinfo->ofs_map[mid].offset)
+	hi = mid;
+      else
+	lo = mid + 1;
     }
-  return lenA - lenB;
+  if (lo == 0)
+    return NULL;
+
+  ofs = &secinfo->ofs_map[lo - 1];
+  if (ofs->entry->len == 0
+      || offset - ofs->offset >= ofs->entry->len)
+    return NULL;
+
+  *pstart = secinfo->contents + ofs->offset;
+  return ofs->entry;
 }
 
-/* Like strrevcmp, but for the case where all strings have the same
-   alignment > entsize.  */
+/* Return the key used to sort E at DEPTH.  For DEPTH -1 this is the
+   misalignment of the end of the string, LEN & TAIL_MASK.  Otherwise
+   it is one more than the character DEPTH places before the end of the
+   string, or zero if the string is no longer than DEPTH.  */
+
+static inline int
+strrevchar (const struct sec_merge_hash_entry *e, int depth,
+	    unsigned int tail_mask)
+{
+  if (depth < 0)
+    return e->len & tail_mask;
+  if ((unsigned int) depth >= e->len)
+    return 0;
+  return ((const unsigned char *) e->root.string)[e->len - 1 - depth] + 1;
+}
+
+/* Compare the strings in two sec_merge_hash_entry structures
+   backwards, starting at DEPTH.  A string sorts before any longer
+   string of which it is a suffix.  */
 
 static int
-strrevcmp_align (const void *a, const void *b)
+strrevcmp (const struct sec_merge_hash_entry *A,
+	   const struct sec_merge_hash_entry *B, int depth,
+	   unsigned int tail_mask)
+{
+  for (;; depth++)
+    {
+      int a = strrevchar (A, depth, tail_mask);
+      int b = strrevchar (B, depth, tail_mask);
+
+      if (a != b)
+	return a - b;
+      if (a == 0 && depth >= 0)
+	return 0;
+    }
+}
+
+/* Sort the N entries in ARRAY, whose keys agree before DEPTH, into
+   strrevcmp order.  This is a multikey quicksort: each partitioning
+   step looks at a single character of each string, so common suffixes
+   are not compared over and over again as they would be by qsort.
+   When all strings have the same alignment > entsize, the caller
+   passes a DEPTH of -1 and a nonzero TAIL_MASK to sort first on the
+   alignment of the end of the strings.  */
+
+static void
+strrevsort (struct sec_merge_hash_entry **array, size_t n, int depth,
+	    unsigned int tail_mask)
 {
-  struct sec_merge_hash_entry *A = *(struct sec_merge_hash_entry **) a;
-  struct sec_merge_hash_entry *B = *(struct sec_merge_hash_entry **) b;
-  unsigned int lenA = A->len;
-  unsigned int lenB = B->len;
-  const unsigned char *s = (const unsigned char *) A->root.string + lenA - 1;
-  const unsigned char *t = (const unsigned char *) B->root.string + lenB - 1;
-  int l = lenA < lenB ? lenA : lenB;
-  int tail_align = (lenA & (A->alignment - 1)) - (lenB & (A->alignment - 1));
-
-  if (tail_align != 0)
-    return tail_align;
-
-  while (l)
+  struct sec_merge_hash_entry *tmp;
+
+  while (n > 1)
     {
-      if (*s != *t)
-	return (int) *s - (int) *t;
-      s--;
-      t--;
-      l--;
+      size_t lt, gt, i;
+      int pivot, a, b, c;
+
+      if (n < 8)
+	{
+	  for (i = 1; i < n; i++)
+	    for (lt = i;
+		 lt > 0 && strrevcmp (array[lt - 1], array[lt], depth,
+				      tail_mask) > 0;
+		 lt--)
+	      {
+		tmp = array[lt];
+		array[lt] = array[lt - 1];
+		array[lt - 1] = tmp;
+	      }
+	  return;
+	}
+
+      /* Partition around the median of three keys into those less
+	 than, equal to and greater than the pivot.  */
+      a = strrevchar (array[0], depth, tail_mask);
+      b = strrevchar (array[n / 2], depth, tail_mask);
+      if (a > b)
+	{
+	  c = a;
+	  a = b;
+	  b = c;
+	}
+      c = strrevchar (array[n - 1], depth, tail_mask);
+      pivot = c < a ? a : c > b ? b : c;
+
+      lt = 0;
+      gt = n;
+      i = 0;
+      while (i < gt)
+	{
+	  c = strrevchar (array[i], depth, tail_mask);
+	  if (c < pivot)
+	    {
+	      tmp = array[lt];
+	      array[lt++] = array[i];
+	      array[i++] = tmp;
+	    }
+	  else if (c > pivot)
+	    {
+	      tmp = array[--gt];
+	      array[gt] = array[i];
+	      array[i] = tmp;
+	    }
+	  else
+	    i++;
+	}
+
+      strrevsort (array, lt, depth, tail_mask);
+      strrevsort (array + gt, n - gt, depth, tail_mask);
+
+      /* The strings are distinct, so only one can end here.  */
+      if (pivot == 0 && depth >= 0)
+	return;
+      array += lt;
+      n = gt - lt;
+      depth++;
     }
-  return lenA - lenB;
 }
 
 static inline int
@@ -625,10 +792,10 @@ merge_strings (struct sec_merge_info *sinfo)
   sinfo->htab->size = a - array;
   if (sinfo->htab->size != 0)
     {
-      qsort (array, (size_t) sinfo->htab->size,
-	     sizeof (struct sec_merge_hash_entry *),
-	     (alignment != (unsigned) -1 && alignment > sinfo->htab->entsize
-	      ? strrevcmp_align : strrevcmp));
+      if (alignment != (unsigned) -1 && alignment > sinfo->htab->entsize)
+	strrevsort (array, (size_t) sinfo->htab->size, -1, alignment - 1);
+      else
+	strrevsort (array, (size_t) sinfo->htab->size, 0, 0);
 
       /* Loop over the sorted array and merge suffixes */
       e = *--a;
@@ -834,38 +1001,42 @@ _bfd_merged_section_offset (bfd *output_bfd ATTRIBUTE_UNUSED, asection **psec,
       return secinfo->first_str ? sec->size : 0;
     }
 
-  if (secinfo->htab->strings)
+  entry = lookup_recorded_entity (secinfo, offset, &p);
+  if (!entry)
     {
-      if (sec->entsize == 1)
+      if (secinfo->htab->strings)
 	{
-	  p = secinfo->contents + offset - 1;
-	  while (p >= secinfo->contents && *p)
-	    --p;
-	  ++p;
+	  if (sec->entsize == 1)
+	    {
+	      p = secinfo->contents + offset - 1;
+	      while (p >= secinfo->contents && *p)
+		--p;
+	      ++p;
+	    }
+	  else
+	    {
+	      p = secinfo->contents + (offset / sec->entsize) * sec->entsize;
+	      p -= sec->entsize;
+	      while (p >= secinfo->contents)
+		{
+		  unsigned int i;
+
+		  for (i = 0; i < sec->entsize; ++i)
+		    if (p[i] != '\0')
+		      break;
+		  if (i == sec->entsize)
+		    break;
+		  p -= sec->entsize;
+		}
+	      p += sec->entsize;
+	    }
 	}
       else
 	{
 	  p = secinfo->contents + (offset / sec->entsize) * sec->entsize;
-	  p -= sec->entsize;
-	  while (p >= secinfo->contents)
-	    {
-	      unsigned int i;
-
-	      for (i = 0; i < sec->entsize; ++i)
-		if (p[i] != '\0')
-		  break;
-	      if (i == sec->entsize)
-		break;
-	      p -= sec->entsize;
-	    }
-	  p += sec->entsize;
 	}
+      entry = sec_merge_hash_lookup (secinfo->htab, (char *) p, 0, FALSE);
     }
-  else
-    {
-      p = secinfo->contents + (offset / sec->entsize) * sec->entsize;
-    }
-  entry = sec_merge_hash_lookup (secinfo->htab, (char *) p, 0, FALSE);
   if (!entry)
     {
       if (! secinfo->htab->strings)
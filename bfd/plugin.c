@@ -264,10 +264,68 @@ bfd_plugin_set_plugin (const char *p)
   plugin_name = p;
 }
 
+/* Return the directory searched for plugins when none has been named,
+   or NULL if there is none.  The result is malloc'd.  */
+
+static char *
+get_plugin_dir (void)
+{
+  char *plugin_dir;
+  char *p;
+
+  if (plugin_program_name == NULL)
+    return NULL;
+
+  plugin_dir = concat (BINDIR, "/../lib/bfd-plugins", NULL);
+  p = make_relative_prefix (plugin_program_name,
+			    BINDIR,
+			    plugin_dir);
+  free (plugin_dir);
+  return p;
+}
+
+/* Return TRUE if objects may be claimed by a plugin, either because
+   one was named with bfd_plugin_set_plugin, or because there are files
+   in the plugin directory.  */
+
+bfd_boolean
+bfd_plugin_specified_p (void)
+{
+  static int in_plugin_dir = -1;
+
+  if (plugin_name != NULL)
+    return TRUE;
+
+  if (in_plugin_dir < 0)
+    {
+      char *p = get_plugin_dir ();
+      DIR *d;
+      struct dirent *ent;
+
+      in_plugin_dir = 0;
+      d = p != NULL ? opendir (p) : NULL;
+      if (d != NULL)
+	{
+	  while (!in_plugin_dir && (ent = readdir (d)) != NULL)
+	    {
+	      char *full_name = concat (p, "/", ent->d_name, NULL);
+	      struct stat s;
+
+	      if (stat (full_name, &s) == 0 && S_ISREG (s.st_mode))
+		in_plugin_dir = 1;
+	      free (full_name);
+	    }
+	  closedir (d);
+	}
+      free (p);
+    }
+
+  return in_plugin_dir;
+}
+
 static int
 load_plugin (bfd *abfd)
 {
-  char *plugin_dir;
   char *p;
   DIR *d;
   struct dirent *ent;
@@ -276,16 +334,10 @@ load_plugin (bfd *abfd)
   if (plugin_name)
     return try_load_plugin (plugin_name, abfd);
 
-  if (plugin_program_name == NULL)
+  p = get_plugin_dir ();
+  if (p == NULL)
     return 0;
 
-  plugin_dir = concat (BINDIR, "/../lib/bfd-plugins", NULL);
-  p = make_relative_prefix (plugin_program_name,
-			    BINDIR,
-			    plugin_dir);
-  free (plugin_dir);
-  plugin_dir = NULL;
-
   d = opendir (p);
   if (!d)
     goto out;
@@ -25,6 +25,7 @@
 
 void bfd_plugin_set_program_name (const char *);
 void bfd_plugin_set_plugin (const char *);
+bfd_boolean bfd_plugin_specified_p (void);
 
 typedef struct plugin_data_struct
 {
@@ -137,6 +137,10 @@ SUBSECTION
 #include "libbfd.h"
 #include "bfdlink.h"
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 /*
 DOCDD
 INODE
@@ -1598,6 +1602,111 @@ bfd_malloc_and_get_section (bfd *abfd, sec_ptr sec, bfd_byte **buf)
   *buf = NULL;
   return bfd_get_full_section_contents (abfd, sec, buf);
 }
+
+/*
+FUNCTION
+	bfd_map_section_contents
+
+SYNOPSIS
+	bfd_boolean bfd_map_section_contents
+	  (bfd *abfd, asection *section, bfd_byte **buf,
+	   void **map_addr, bfd_size_type *map_len);
+
+DESCRIPTION
+	Return a read-only view of all data from @var{section} in BFD
+	@var{abfd} in *@var{buf}.  When the section contents are stored
+	verbatim in the file, the view points into a mmap()ed region of
+	the file and the page aligned address and length of the mapping
+	are written to *@var{map_addr} and *@var{map_len}.  Otherwise
+	*@var{map_addr} is set to NULL and the data is read as for
+	<<bfd_get_full_section_contents>>: into *@var{buf} if it is not
+	NULL on entry, else into a buffer malloc'd by this function.
+	The caller must not write to a mapped view, and must release
+	it, or the malloc'd buffer, with <<bfd_unmap_section_contents>>.
+*/
+
+bfd_boolean
+bfd_map_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **buf,
+			  void **map_addr, bfd_size_type *map_len)
+{
+#ifdef HAVE_MMAP
+  static bfd_size_type pagesize;
+  bfd_size_type sz = sec->rawsize ? sec->rawsize : sec->size;
+
+  if (pagesize == 0)
+    pagesize = getpagesize ();
+
+  /* Only map sections which are large enough that the page rounding
+     does not waste too much address space, whose contents are read
+     verbatim from the file, and which do not live in a nested
+     archive, since bfd_mmap only applies the origin of the
+     innermost archive.  */
+  if (abfd->direction == read_direction
+      && (abfd->flags & BFD_IN_MEMORY) == 0
+      && (abfd->my_archive == NULL
+	  || abfd->my_archive->my_archive == NULL)
+      && (sec->flags & (SEC_HAS_CONTENTS | SEC_IN_MEMORY
+			| SEC_CONSTRUCTOR)) == SEC_HAS_CONTENTS
+      && sec->compress_status == COMPRESS_SECTION_NONE
+      && (abfd->xvec->_bfd_get_section_contents
+	  == _bfd_generic_get_section_contents)
+      && sz > 4 * pagesize)
+    {
+      file_ptr filesize = bfd_get_size (abfd);
+      file_ptr offset = sec->filepos;
+      void *ret;
+
+      if (abfd->my_archive != NULL)
+	offset += abfd->origin;
+      if (filesize > 0
+	  && offset >= 0
+	  && (bfd_size_type) offset <= (bfd_size_type) filesize
+	  && sz <= (bfd_size_type) filesize - offset)
+	{
+	  ret = bfd_mmap (abfd, NULL, sz, PROT_READ, MAP_PRIVATE,
+			  sec->filepos, map_addr, map_len);
+	  if (ret != (void *) -1)
+	    {
+	      *buf = (bfd_byte *) ret;
+	      return TRUE;
+	    }
+	}
+    }
+#endif
+
+  *map_addr = NULL;
+  *map_len = 0;
+  return bfd_get_full_section_contents (abfd, sec, buf);
+}
+
+/*
+FUNCTION
+	bfd_unmap_section_contents
+
+SYNOPSIS
+	void bfd_unmap_section_contents
+	  (bfd_byte *buf, void *map_addr, bfd_size_type map_len);
+
+DESCRIPTION
+	Release a view of section data returned by
+	<<bfd_map_section_contents>>.
+*/
+
+void
+bfd_unmap_section_contents (bfd_byte *buf, void *map_addr ATTRIBUTE_UNUSED,
+			    bfd_size_type map_len ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_MMAP
+  if (map_addr != NULL)
+    {
+      munmap (map_addr, map_len);
+      return;
+    }
+#endif
+  if (buf != NULL)
+    free (buf);
+}
+
 /*
 FUNCTION
 	bfd_copy_private_section_data
@@ -26,9 +26,12 @@
    addr2line [options] addr addr ...
    or
    addr2line [options]
+   or
+   addr2line [options] --server
 
-   both forms write results to stdout, the second form reads addresses
-   to be converted from stdin.  */
+   all forms write results to stdout, the second form reads addresses
+   to be converted from stdin, and the third form reads both the names
+   of the files to use and addresses from stdin.  */
 
 #include "sysdep.h"
 #include "bfd.h"
@@ -50,6 +53,14 @@ static char **addr;		/* Hex addresses to process.  */
 
 static asymbol **syms;		/* Symbol table.  */
 
+/* The default number of files that --server keeps open.  */
+#define DEFAULT_SERVER_CACHE_SIZE 16
+
+enum option_values
+  {
+    OPTION_SERVER = 150
+  };
+
 static struct option long_options[] =
 {
   {"addresses", no_argument, NULL, 'a'},
@@ -60,6 +71,7 @@ static struct option long_options[] =
   {"inlines", no_argument, NULL, 'i'},
   {"pretty-print", no_argument, NULL, 'p'},
   {"section", required_argument, NULL, 'j'},
+  {"server", optional_argument, NULL, OPTION_SERVER},
   {"target", required_argument, NULL, 'b'},
   {"help", no_argument, NULL, 'H'},
   {"version", no_argument, NULL, 'V'},
@@ -67,10 +79,13 @@ static struct option long_options[] =
 };
 
 static void usage (FILE *, int);
+static bfd_boolean read_symtab (bfd *);
 static void slurp_symtab (bfd *);
 static void find_address_in_section (bfd *, asection *, void *);
 static void find_offset_in_section (bfd *, asection *);
+static void translate_address (bfd *, asection *, const char *);
 static void translate_addresses (bfd *, asection *);
+static int serve (const char *, const char *, const char *, int);
 
 /* Print a usage message to STREAM and exit with STATUS.  */
 
@@ -88,6 +103,9 @@ usage (FILE *stream, int status)
   -i --inlines           Unwind inlined functions\n\
   -j --section=<name>    Read section-relative offsets instead of addresses\n\
   -p --pretty-print      Make the output easier to read for humans\n\
+  --server[=<number>]    Read addresses from stdin, each group preceded by a\n\
+                          line \"@<file>\" naming the file to look in (not an\n\
+                          option file); keep up to <number> files open\n\
   -s --basenames         Strip directory names\n\
   -f --functions         Show function names\n\
   -C --demangle[=style]  Demangle function names\n\
@@ -101,17 +119,18 @@ usage (FILE *stream, int status)
   exit (status);
 }
 
-/* Read in the symbol table.  */
+/* Read in the symbol table.  Return FALSE, with the BFD error set,
+   if it cannot be read.  */
 
-static void
-slurp_symtab (bfd *abfd)
+static bfd_boolean
+read_symtab (bfd *abfd)
 {
   long storage;
   long symcount;
   bfd_boolean dynamic = FALSE;
 
   if ((bfd_get_file_flags (abfd) & HAS_SYMS) == 0)
-    return;
+    return TRUE;
 
   storage = bfd_get_symtab_upper_bound (abfd);
   if (storage == 0)
@@ -120,7 +139,7 @@ slurp_symtab (bfd *abfd)
       dynamic = TRUE;
     }
   if (storage < 0)
-    bfd_fatal (bfd_get_filename (abfd));
+    return FALSE;
 
   syms = (asymbol **) xmalloc (storage);
   if (dynamic)
@@ -128,7 +147,11 @@ slurp_symtab (bfd *abfd)
   else
     symcount = bfd_canonicalize_symtab (abfd, syms);
   if (symcount < 0)
-    bfd_fatal (bfd_get_filename (abfd));
+    {
+      free (syms);
+      syms = NULL;
+      return FALSE;
+    }
 
   /* If there are no symbols left after canonicalization and
      we have not tried the dynamic symbols then give them a go.  */
@@ -148,6 +171,17 @@ slurp_symtab (bfd *abfd)
       free (syms);
       syms = NULL;
     }
+
+  return TRUE;
+}
+
+/* Read in the symbol table, exiting if it cannot be read.  */
+
+static void
+slurp_symtab (bfd *abfd)
+{
+  if (! read_symtab (abfd))
+    bfd_fatal (bfd_get_filename (abfd));
 }
 
 /* These global variables are used to pass information between
@@ -211,139 +245,173 @@ find_offset_in_section (bfd *abfd, asection *section)
                                                &line, &discriminator);
 }
 
-/* Read hexadecimal addresses from stdin, translate into
-   file_name:line_number and optionally function name.  */
+/* Translate the hexadecimal address ADDR_HEX into file_name:line_number
+   and optionally function name.  If ABFD is NULL, no file could be
+   opened, and the address cannot be translated.  */
 
 static void
-translate_addresses (bfd *abfd, asection *section)
+translate_address (bfd *abfd, asection *section, const char *addr_hex)
 {
-  int read_stdin = (naddr == 0);
+  pc = bfd_scan_vma (addr_hex, NULL, 16);
 
-  for (;;)
+  if (abfd == NULL)
     {
-      if (read_stdin)
+      if (with_addresses)
 	{
-	  char addr_hex[100];
+	  printf ("0x");
+	  printf_vma (pc);
 
-	  if (fgets (addr_hex, sizeof addr_hex, stdin) == NULL)
-	    break;
-	  pc = bfd_scan_vma (addr_hex, NULL, 16);
+	  if (pretty_print)
+	    printf (": ");
+	  else
+	    printf ("\n");
 	}
-      else
+      if (with_functions)
 	{
-	  if (naddr <= 0)
-	    break;
-	  --naddr;
-	  pc = bfd_scan_vma (*addr++, NULL, 16);
+	  if (pretty_print)
+	    printf ("?? ");
+	  else
+	    printf ("??\n");
 	}
+      printf ("??:0\n");
+      return;
+    }
 
-      if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
-	{
-	  const struct elf_backend_data *bed = get_elf_backend_data (abfd);
-	  bfd_vma sign = (bfd_vma) 1 << (bed->s->arch_size - 1);
+  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
+    {
+      const struct elf_backend_data *bed = get_elf_backend_data (abfd);
+      bfd_vma sign = (bfd_vma) 1 << (bed->s->arch_size - 1);
 
-	  pc &= (sign << 1) - 1;
-	  if (bed->sign_extend_vma)
-	    pc = (pc ^ sign) - sign;
-	}
+      pc &= (sign << 1) - 1;
+      if (bed->sign_extend_vma)
+	pc = (pc ^ sign) - sign;
+    }
 
-      if (with_addresses)
-        {
-          printf ("0x");
-          bfd_printf_vma (abfd, pc);
-
-          if (pretty_print)
-            printf (": ");
-          else
-            printf ("\n");
-        }
-
-      found = FALSE;
-      if (section)
-	find_offset_in_section (abfd, section);
+  if (with_addresses)
+    {
+      printf ("0x");
+      bfd_printf_vma (abfd, pc);
+
+      if (pretty_print)
+	printf (": ");
       else
-	bfd_map_over_sections (abfd, find_address_in_section, NULL);
+	printf ("\n");
+    }
 
-      if (! found)
+  found = FALSE;
+  if (section)
+    find_offset_in_section (abfd, section);
+  else
+    bfd_map_over_sections (abfd, find_address_in_section, NULL);
+
+  if (! found)
+    {
+      if (with_functions)
+	{
+	  if (pretty_print)
+	    printf ("?? ");
+	  else
+	    printf ("??\n");
+	}
+      printf ("??:0\n");
+    }
+  else
+    {
+      while (1)
 	{
 	  if (with_functions)
 	    {
+	      const char *name;
+	      char *alloc = NULL;
+
+	      name = functionname;
+	      if (name == NULL || *name == '\0')
+		name = "??";
+	      else if (do_demangle)
+		{
+		  alloc = cached_demangle (bfd_demangle, abfd, name,
+					   DMGL_ANSI | DMGL_PARAMS);
+		  if (alloc != NULL)
+		    name = alloc;
+		}
+
+	      printf ("%s", name);
 	      if (pretty_print)
-		printf ("?? ");
+		/* Note for translators:  This printf is used to join the
+		   function name just printed above to the line number/
+		   file name pair that is about to be printed below.  Eg:
+
+		     foo at 123:bar.c  */
+		printf (_(" at "));
 	      else
-		printf ("??\n");
+		printf ("\n");
+
+	      if (alloc != NULL)
+		free (alloc);
 	    }
-	  printf ("??:0\n");
+
+	  if (base_names && filename != NULL)
+	    {
+	      char *h;
+
+	      h = strrchr (filename, '/');
+	      if (h != NULL)
+		filename = h + 1;
+	    }
+
+	  printf ("%s:", filename ? filename : "??");
+	  if (line != 0)
+	    {
+	      if (discriminator != 0)
+		printf ("%u (discriminator %u)\n", line, discriminator);
+	      else
+		printf ("%u\n", line);
+	    }
+	  else
+	    printf ("?\n");
+	  if (!unwind_inlines)
+	    found = FALSE;
+	  else
+	    found = bfd_find_inliner_info (abfd, &filename, &functionname,
+					   &line);
+	  if (! found)
+	    break;
+	  if (pretty_print)
+	    /* Note for translators: This printf is used to join the
+	       line number/file name pair that has just been printed with
+	       the line number/file name pair that is going to be printed
+	       by the next iteration of the while loop.  Eg:
+
+		 123:bar.c (inlined by) 456:main.c  */
+	    printf (_(" (inlined by) "));
+	}
+    }
+}
+
+/* Read hexadecimal addresses from stdin, translate into
+   file_name:line_number and optionally function name.  */
+
+static void
+translate_addresses (bfd *abfd, asection *section)
+{
+  int read_stdin = (naddr == 0);
+
+  for (;;)
+    {
+      if (read_stdin)
+	{
+	  char addr_hex[100];
+
+	  if (fgets (addr_hex, sizeof addr_hex, stdin) == NULL)
+	    break;
+	  translate_address (abfd, section, addr_hex);
 	}
       else
 	{
-	  while (1)
-            {
-              if (with_functions)
-                {
-                  const char *name;
-                  char *alloc = NULL;
-
-                  name = functionname;
-                  if (name == NULL || *name == '\0')
-                    name = "??";
-                  else if (do_demangle)
-                    {
-                      alloc = bfd_demangle (abfd, name, DMGL_ANSI | DMGL_PARAMS);
-                      if (alloc != NULL)
-                        name = alloc;
-                    }
-
-                  printf ("%s", name);
-                  if (pretty_print)
-		    /* Note for translators:  This printf is used to join the
-		       function name just printed above to the line number/
-		       file name pair that is about to be printed below.  Eg:
-
-		         foo at 123:bar.c  */
-                    printf (_(" at "));
-                  else
-                    printf ("\n");
-
-                  if (alloc != NULL)
-                    free (alloc);
-                }
-
-              if (base_names && filename != NULL)
-                {
-                  char *h;
-
-                  h = strrchr (filename, '/');
-                  if (h != NULL)
-                    filename = h + 1;
-                }
-
-              printf ("%s:", filename ? filename : "??");
-	      if (line != 0)
-                {
-                  if (discriminator != 0)
-                    printf ("%u (discriminator %u)\n", line, discriminator);
-                  else
-                    printf ("%u\n", line);
-                }
-	      else
-		printf ("?\n");
-              if (!unwind_inlines)
-                found = FALSE;
-              else
-                found = bfd_find_inliner_info (abfd, &filename, &functionname,
-					       &line);
-              if (! found)
-                break;
-              if (pretty_print)
-		/* Note for translators: This printf is used to join the
-		   line number/file name pair that has just been printed with
-		   the line number/file name pair that is going to be printed
-		   by the next iteration of the while loop.  Eg:
-
-		     123:bar.c (inlined by) 456:main.c  */
-                printf (_(" (inlined by) "));
-            }
+	  if (naddr <= 0)
+	    break;
+	  --naddr;
+	  translate_address (abfd, section, *addr++);
 	}
 
       /* fflush() is essential for using this command as a server
@@ -411,6 +479,266 @@ process_file (const char *file_name, const char *section_name,
 
   return 0;
 }
+
+/* A file opened by --server.  The file is kept open, together with
+   its symbol table and the debugging information that BFD has read
+   from it, until it is evicted from the cache.  */
+
+struct server_file
+{
+  struct server_file *next;	/* Next most recently used file.  */
+  char *name;
+  bfd *abfd;
+  asection *section;		/* The section given by -j, if any.  */
+  asymbol **syms;
+  time_t mtime;			/* For noticing that the file changed.  */
+  off_t size;
+};
+
+/* Close FILE and free it.  */
+
+static void
+server_close_file (struct server_file *file)
+{
+  if (file->syms != NULL)
+    free (file->syms);
+  bfd_close (file->abfd);
+  free (file->name);
+  free (file);
+}
+
+/* Open FILE_NAME for --server.  Unlike process_file, report problems
+   without exiting, and return NULL.  */
+
+static struct server_file *
+server_open_file (const char *file_name, const char *section_name,
+		  const char *target, struct stat *st)
+{
+  struct server_file *file;
+  bfd *abfd;
+  asection *section;
+  char **matching;
+
+  abfd = bfd_openr (file_name, target);
+  if (abfd == NULL)
+    {
+      bfd_nonfatal (file_name);
+      return NULL;
+    }
+
+  /* Decompress sections.  */
+  abfd->flags |= BFD_DECOMPRESS;
+
+  if (bfd_check_format (abfd, bfd_archive))
+    {
+      non_fatal (_("%s: cannot get addresses from archive"), file_name);
+      bfd_close (abfd);
+      return NULL;
+    }
+
+  if (! bfd_check_format_matches (abfd, bfd_object, &matching))
+    {
+      bfd_nonfatal (bfd_get_filename (abfd));
+      if (bfd_get_error () == bfd_error_file_ambiguously_recognized)
+	{
+	  list_matching_formats (matching);
+	  free (matching);
+	}
+      bfd_close (abfd);
+      return NULL;
+    }
+
+  if (section_name != NULL)
+    {
+      section = bfd_get_section_by_name (abfd, section_name);
+      if (section == NULL)
+	{
+	  non_fatal (_("%s: cannot find section %s"), file_name, section_name);
+	  bfd_close (abfd);
+	  return NULL;
+	}
+    }
+  else
+    section = NULL;
+
+  if (! read_symtab (abfd))
+    {
+      bfd_nonfatal (file_name);
+      bfd_close (abfd);
+      return NULL;
+    }
+
+  file = (struct server_file *) xmalloc (sizeof (*file));
+  file->next = NULL;
+  file->name = xstrdup (file_name);
+  file->abfd = abfd;
+  file->section = section;
+  file->syms = syms;
+  file->mtime = st->st_mtime;
+  file->size = st->st_size;
+  syms = NULL;
+
+  return file;
+}
+
+/* Read a line from STREAM into *BUF, which has room for *SIZE bytes
+   and is enlarged as needed.  Remove the newline.  Return FALSE at
+   end of file.  */
+
+static bfd_boolean
+server_read_line (FILE *stream, char **buf, size_t *size)
+{
+  size_t len = 0;
+
+  for (;;)
+    {
+      if (fgets (*buf + len, *size - len, stream) == NULL)
+	{
+	  if (len == 0)
+	    return FALSE;
+	  break;
+	}
+      len += strlen (*buf + len);
+      if (len > 0 && (*buf)[len - 1] == '\n')
+	{
+	  (*buf)[--len] = '\0';
+	  break;
+	}
+      if (len + 1 < *size)
+	/* The last line is not newline terminated.  */
+	break;
+      *size *= 2;
+      *buf = (char *) xrealloc (*buf, *size);
+    }
+
+  if (len > 0 && (*buf)[len - 1] == '\r')
+    (*buf)[--len] = '\0';
+
+  return TRUE;
+}
+
+/* Act as a server, reading requests from stdin.  A line of the form
+   "@FILE" makes FILE the file in which the following addresses are
+   looked up (unlike an @FILE argument, no options are read from it),
+   and any other non-empty line is an address to translate.
+   An empty line is answered with an empty line, so that a client can
+   find the end of the output for a batch of addresses whatever the
+   number of lines printed for each.  Up to CACHE_SIZE files are kept
+   open, so that switching back to a file does not mean reading its
+   symbols and debugging information again.  If FILE_NAME is not NULL
+   it is the file to use until another is named.  Returns an exit value
+   for main().  */
+
+static int
+serve (const char *file_name, const char *section_name, const char *target,
+       int cache_size)
+{
+  struct server_file *files = NULL;
+  struct server_file *current = NULL;
+  size_t size = 256;
+  char *buf = (char *) xmalloc (size);
+  int status = 0;
+
+  if (file_name != NULL)
+    {
+      struct stat st;
+
+      if (stat (file_name, &st) == 0)
+	current = server_open_file (file_name, section_name, target, &st);
+      else
+	non_fatal (_("'%s': No such file"), file_name);
+      if (current == NULL)
+	status = 1;
+      files = current;
+    }
+
+  while (server_read_line (stdin, &buf, &size))
+    {
+      if (buf[0] == '@')
+	{
+	  struct server_file **pp;
+	  struct server_file *file;
+	  struct stat st;
+	  int count;
+
+	  current = NULL;
+	  if (stat (buf + 1, &st) != 0)
+	    {
+	      non_fatal (_("'%s': No such file"), buf + 1);
+	      status = 1;
+	      continue;
+	    }
+
+	  /* Look for the file in the cache, most recently used first,
+	     dropping any entry for it that is out of date.  */
+	  for (pp = &files; (file = *pp) != NULL; pp = &file->next)
+	    if (strcmp (file->name, buf + 1) == 0)
+	      {
+		*pp = file->next;
+		if (file->mtime != st.st_mtime || file->size != st.st_size)
+		  {
+		    server_close_file (file);
+		    file = NULL;
+		  }
+		break;
+	      }
+
+	  if (file == NULL)
+	    {
+	      file = server_open_file (buf + 1, section_name, target, &st);
+	      if (file == NULL)
+		{
+		  status = 1;
+		  continue;
+		}
+	    }
+
+	  file->next = files;
+	  files = file;
+	  current = file;
+
+	  /* Evict the least recently used files.  */
+	  for (count = 1, pp = &files->next;
+	       *pp != NULL;
+	       count++, pp = &(*pp)->next)
+	    if (count >= cache_size)
+	      {
+		while ((file = *pp) != NULL)
+		  {
+		    *pp = file->next;
+		    server_close_file (file);
+		  }
+		break;
+	      }
+	}
+      else
+	{
+	  if (buf[0] == '\0')
+	    putchar ('\n');
+	  else if (current != NULL)
+	    {
+	      syms = current->syms;
+	      translate_address (current->abfd, current->section, buf);
+	      syms = NULL;
+	    }
+	  else
+	    translate_address (NULL, NULL, buf);
+
+	  fflush (stdout);
+	}
+    }
+
+  while (files != NULL)
+    {
+      struct server_file *next = files->next;
+
+      server_close_file (files);
+      files = next;
+    }
+  free (buf);
+
+  return status;
+}
 
 int
 main (int argc, char **argv)
@@ -418,6 +746,7 @@ main (int argc, char **argv)
   const char *file_name;
   const char *section_name;
   char *target;
+  int server_cache_size = 0;
   int c;
 
 #if defined (HAVE_SETLOCALE) && defined (HAVE_LC_MESSAGES)
@@ -494,12 +823,30 @@ main (int argc, char **argv)
 	case 'j':
 	  section_name = optarg;
 	  break;
+	case OPTION_SERVER:
+	  server_cache_size = DEFAULT_SERVER_CACHE_SIZE;
+	  if (optarg != NULL)
+	    {
+	      char *end;
+
+	      server_cache_size = (int) strtol (optarg, &end, 0);
+	      if (*end != '\0' || server_cache_size < 1)
+		fatal (_("invalid number of files to keep open: %s"), optarg);
+	    }
+	  break;
 	default:
 	  usage (stderr, 1);
 	  break;
 	}
     }
 
+  if (server_cache_size != 0)
+    {
+      if (optind != argc)
+	usage (stderr, 1);
+      return serve (file_name, section_name, target, server_cache_size);
+    }
+
   if (file_name == NULL)
     file_name = "a.out";
 
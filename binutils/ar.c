@@ -1154,6 +1154,13 @@ write_archive (bfd *iarch)
      been explicitly requested not to.  */
   obfd->has_armap = write_armap >= 0;
 
+  /* When the symbol table was asked for explicitly, as by ranlib or
+     the `s' modifier, rebuild it from every member's symbols, rather
+     than carrying the entries of unchanged members over from the old
+     one, since that might be out of date.  */
+  if (write_armap > 0)
+    bfd_has_map (iarch) = FALSE;
+
   if (ar_truncate)
     {
       /* This should really use bfd_set_file_flags, but that rejects
@@ -26,6 +26,7 @@
 #include "libiberty.h"
 #include "filenames.h"
 #include "libbfd.h"
+#include "hashtab.h"
 
 #include <time.h>		/* ctime, maybe time_t */
 #include <assert.h>
@@ -650,3 +651,108 @@ is_valid_archive_path (char const * pathname)
 
   return TRUE;
 }
+
+/* Demangled names are remembered in a hash table, so that a symbol
+   which is printed many times (as in nm of a large archive, or when
+   piping a linker map through c++filt) is demangled only once.  Names
+   which are not mangled are remembered too, since they are usually
+   the majority.  */
+
+struct demangle_entry
+{
+  /* The lookup key.  */
+  demangler_fn demangler;
+  int leading_char;
+  int options;
+  const char *name;
+
+  /* The demangled name, or NULL if NAME is not a mangled name.  */
+  char *demangled;
+};
+
+/* The table is thrown away and started again once the names held in
+   it use more than this many bytes, so that memory use stays bounded
+   no matter how many distinct symbols are seen.  */
+#define DEMANGLE_CACHE_LIMIT (16 * 1024 * 1024)
+
+static htab_t demangle_cache;
+static size_t demangle_cache_size;
+
+static hashval_t
+demangle_entry_hash (const void *p)
+{
+  const struct demangle_entry *e = (const struct demangle_entry *) p;
+
+  return htab_hash_string (e->name) ^ (e->options * 31 + e->leading_char);
+}
+
+static int
+demangle_entry_eq (const void *p1, const void *p2)
+{
+  const struct demangle_entry *e1 = (const struct demangle_entry *) p1;
+  const struct demangle_entry *e2 = (const struct demangle_entry *) p2;
+
+  return (e1->demangler == e2->demangler
+	  && e1->leading_char == e2->leading_char
+	  && e1->options == e2->options
+	  && strcmp (e1->name, e2->name) == 0);
+}
+
+static void
+demangle_entry_del (void *p)
+{
+  struct demangle_entry *e = (struct demangle_entry *) p;
+
+  free (e->demangled);
+  free (e);
+}
+
+/* Return the result of calling DEMANGLER on NAME, read from ABFD, with
+   OPTIONS, looking it up in the cache first.  The result is malloc'd
+   and must be freed by the caller, as for bfd_demangle.  ABFD may be
+   NULL.  */
+
+char *
+cached_demangle (demangler_fn demangler, bfd *abfd, const char *name,
+		 int options)
+{
+  struct demangle_entry key, *e;
+  void **slot;
+  size_t len;
+
+  if (demangle_cache == NULL)
+    demangle_cache = htab_create_alloc (1024, demangle_entry_hash,
+					demangle_entry_eq, demangle_entry_del,
+					xcalloc, free);
+
+  key.demangler = demangler;
+  key.leading_char = abfd != NULL ? bfd_get_symbol_leading_char (abfd) : 0;
+  key.options = options;
+  key.name = name;
+
+  slot = htab_find_slot (demangle_cache, &key, NO_INSERT);
+  if (slot != NULL)
+    {
+      e = (struct demangle_entry *) *slot;
+      return e->demangled != NULL ? xstrdup (e->demangled) : NULL;
+    }
+
+  if (demangle_cache_size > DEMANGLE_CACHE_LIMIT)
+    {
+      htab_empty (demangle_cache);
+      demangle_cache_size = 0;
+    }
+
+  len = strlen (name) + 1;
+  e = (struct demangle_entry *) xmalloc (sizeof (*e) + len);
+  *e = key;
+  e->name = (const char *) memcpy (e + 1, name, len);
+  e->demangled = (*demangler) (abfd, name, options);
+  *htab_find_slot (demangle_cache, e, INSERT) = e;
+
+  demangle_cache_size += sizeof (*e) + len;
+  if (e->demangled == NULL)
+    return NULL;
+  demangle_cache_size += strlen (e->demangled) + 1;
+  return xstrdup (e->demangled);
+}
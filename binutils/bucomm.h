@@ -60,6 +60,10 @@ off_t get_file_size (const char *);
 
 bfd_boolean is_valid_archive_path (char const *);
 
+typedef char *(*demangler_fn) (bfd *, const char *, int);
+
+char *cached_demangle (demangler_fn, bfd *, const char *, int);
+
 extern char *program_name;
 
 /* In filemode.c.  */
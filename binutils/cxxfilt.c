@@ -45,6 +45,15 @@ static const struct option long_options[] =
   {NULL, no_argument, NULL, 0}
 };
 
+/* The size of the blocks in which standard input is read.  */
+#define INPUT_BLOCK_SIZE (64 * 1024)
+
+static char *
+cxxfilt_demangle (bfd *abfd ATTRIBUTE_UNUSED, const char *name, int options)
+{
+  return cplus_demangle (name, options);
+}
+
 static void
 demangle_it (char *mangled_name)
 {
@@ -59,7 +68,8 @@ demangle_it (char *mangled_name)
   if (strip_underscore && mangled_name[skip_first] == '_')
     ++skip_first;
 
-  result = cplus_demangle (mangled_name + skip_first, flags);
+  result = cached_demangle (cxxfilt_demangle, NULL,
+			    mangled_name + skip_first, flags);
 
   if (result == NULL)
     printf ("%s", mangled_name);
@@ -172,6 +182,10 @@ main (int argc, char **argv)
 {
   int c;
   const char *valid_symbols;
+  static char mbuffer[32767];
+  static char block[INPUT_BLOCK_SIZE];
+  char symbol_char[256];
+  unsigned int i;
   enum demangling_styles style = auto_demangling;
 
   program_name = argv[0];
@@ -253,35 +267,55 @@ main (int argc, char **argv)
       fatal ("Internal error: no symbol alphabet for current style");
     }
 
+  for (c = 0; c < 256; c++)
+    symbol_char[c] = ISALNUM (c) || strchr (valid_symbols, c) != NULL;
+
+  /* Read standard input a block at a time rather than a character at
+     a time.  A mangled name may straddle two blocks, so the part seen
+     so far is kept in MBUFFER.  A read from a pipe or terminal returns
+     whatever is available, so output is still produced as soon as a
+     line is typed.  */
+  i = 0;
   for (;;)
     {
-      static char mbuffer[32767];
-      unsigned i = 0;
+      ssize_t len = read (fileno (stdin), block, sizeof (block));
+      const char *p;
 
-      c = getchar ();
-      /* Try to read a mangled name.  */
-      while (c != EOF && (ISALNUM (c) || strchr (valid_symbols, c)))
-	{
-	  if (i >= sizeof (mbuffer) - 1)
-	    break;
-	  mbuffer[i++] = c;
-	  c = getchar ();
-	}
+      if (len < 0 && errno == EINTR)
+	continue;
+      if (len <= 0)
+	break;
 
-      if (i > 0)
+      for (p = block; p < block + len; p++)
 	{
-	  mbuffer[i] = 0;
-	  demangle_it (mbuffer);
+	  c = (unsigned char) *p;
+
+	  /* Collect a mangled name.  */
+	  if (symbol_char[c] && i < sizeof (mbuffer) - 1)
+	    {
+	      mbuffer[i++] = c;
+	      continue;
+	    }
+
+	  if (i > 0)
+	    {
+	      mbuffer[i] = 0;
+	      demangle_it (mbuffer);
+	      i = 0;
+	    }
+
+	  /* Echo the whitespace characters so that the output looks
+	     like the input, only with the mangled names demangled.  */
+	  putchar (c);
 	}
 
-      if (c == EOF)
-	break;
+      fflush (stdout);
+    }
 
-      /* Echo the whitespace characters so that the output looks
-	 like the input, only with the mangled names demangled.  */
-      putchar (c);
-      if (c == '\n')
-	fflush (stdout);
+  if (i > 0)
+    {
+      mbuffer[i] = 0;
+      demangle_it (mbuffer);
     }
 
   fflush (stdout);
@@ -43,6 +43,9 @@ static debug_info *debug_information = NULL;
 /* Special value for num_debug_info_entries to indicate
    that the .debug_info section could not be loaded/parsed.  */
 #define DEBUG_INFO_UNAVAILABLE  (unsigned int) -1
+/* Non-zero if debug_information only describes the unit headers,
+   see load_debug_info_headers.  */
+static int debug_info_headers_only = FALSE;
 
 unsigned int eh_addr_size;
 
@@ -208,6 +211,28 @@ dwarf_vmatoa_1 (const char *fmtch, dwarf_vma value, unsigned num_bytes)
 	num_bytes = 8;
       return ret + (16 - 2 * num_bytes);
     }
+  else if ((fmtch[0] == 'x' || fmtch[0] == 'd' || fmtch[0] == 'u')
+	   && fmtch[1] == '\0')
+    {
+      /* These are used for nearly every attribute that is displayed,
+	 so convert them by hand rather than with snprintf.  */
+      unsigned int base = fmtch[0] == 'x' ? 16 : 10;
+      int negative = fmtch[0] == 'd' && (dwarf_signed_vma) value < 0;
+      char *p = ret + sizeof (buf[0].place);
+
+      if (negative)
+	value = -value;
+      *--p = '\0';
+      do
+	{
+	  *--p = "0123456789abcdef"[value % base];
+	  value /= base;
+	}
+      while (value != 0);
+      if (negative)
+	*--p = '-';
+      return p;
+    }
   else
     {
       char fmt[32];
@@ -691,6 +716,13 @@ abbrev_entry;
 static abbrev_entry *first_abbrev = NULL;
 static abbrev_entry *last_abbrev = NULL;
 
+/* Abbreviations are looked up once for every DIE, and producers
+   number them densely from 1, so entries with small numbers are also
+   indexed directly by their number.  */
+#define ABBREV_LOOKUP_MAX 65536
+static abbrev_entry **abbrev_lookup = NULL;
+static unsigned long abbrev_lookup_size = 0;
+
 static void
 free_abbrevs (void)
 {
@@ -714,6 +746,9 @@ free_abbrevs (void)
     }
 
   last_abbrev = first_abbrev = NULL;
+
+  if (abbrev_lookup_size != 0)
+    memset (abbrev_lookup, 0, abbrev_lookup_size * sizeof (*abbrev_lookup));
 }
 
 static void
@@ -739,6 +774,43 @@ add_abbrev (unsigned long number, unsigned long tag, int children)
     last_abbrev->next = entry;
 
   last_abbrev = entry;
+
+  if (number < ABBREV_LOOKUP_MAX)
+    {
+      if (number >= abbrev_lookup_size)
+	{
+	  unsigned long new_size = abbrev_lookup_size ? abbrev_lookup_size : 64;
+
+	  while (new_size <= number)
+	    new_size *= 2;
+	  abbrev_lookup = (abbrev_entry **)
+	    xrealloc (abbrev_lookup, new_size * sizeof (*abbrev_lookup));
+	  memset (abbrev_lookup + abbrev_lookup_size, 0,
+		  (new_size - abbrev_lookup_size) * sizeof (*abbrev_lookup));
+	  abbrev_lookup_size = new_size;
+	}
+      /* If a number is used twice, the first entry wins, as it
+	 does when searching the list.  */
+      if (abbrev_lookup[number] == NULL)
+	abbrev_lookup[number] = entry;
+    }
+}
+
+/* Return the current abbreviation entry numbered NUMBER, or NULL.  */
+
+static abbrev_entry *
+find_abbrev (unsigned long number)
+{
+  abbrev_entry *entry;
+
+  if (number < ABBREV_LOOKUP_MAX)
+    return number < abbrev_lookup_size ? abbrev_lookup[number] : NULL;
+
+  for (entry = first_abbrev; entry != NULL; entry = entry->next)
+    if (entry->entry == number)
+      break;
+
+  return entry;
 }
 
 static void
@@ -2159,9 +2231,7 @@ read_and_display_attr_value (unsigned long attribute,
 	       yet.  */
 	    if (form != DW_FORM_ref_addr)
 	      {
-		for (entry = first_abbrev; entry != NULL; entry = entry->next)
-		  if (entry->entry == abbrev_number)
-		    break;
+		entry = find_abbrev (abbrev_number);
 		if (entry != NULL)
 		  printf (" (%s)", get_TAG_name (entry->tag));
 	      }
@@ -2218,13 +2288,23 @@ read_and_display_attr (unsigned long attribute,
 		       struct cu_tu_set * this_set)
 {
   if (!do_loc)
-    printf ("   %-18s:", get_AT_name (attribute));
+    {
+      const char *name = get_AT_name (attribute);
+      size_t len = strlen (name);
+
+      /* Equivalent to printf ("   %-18s:", name).  */
+      fputs ("   ", stdout);
+      fputs (name, stdout);
+      for (; len < 18; len++)
+	putchar (' ');
+      putchar (':');
+    }
   data = read_and_display_attr_value (attribute, form, data, end,
 				      cu_offset, pointer_size, offset_size,
 				      dwarf_version, debug_info_p,
 				      do_loc, section, this_set);
   if (!do_loc)
-    printf ("\n");
+    putchar ('\n');
   return data;
 }
 
@@ -2246,6 +2326,20 @@ process_debug_info (struct dwarf_section *section,
   unsigned int unit;
   unsigned int num_units = 0;
 
+  /* An index of the unit headers is not enough if we are going to
+     need the location and range lists, so discard it and build the
+     full information as we go.  */
+  if (debug_info_headers_only
+      && num_debug_info_entries != 0
+      && (do_loc || do_debug_loc || do_debug_ranges)
+      && ! do_types)
+    {
+      free (debug_information);
+      debug_information = NULL;
+      alloc_num_debug_info_entries = num_debug_info_entries = 0;
+      debug_info_headers_only = FALSE;
+    }
+
   if ((do_loc || do_debug_loc || do_debug_ranges)
       && num_debug_info_entries == 0
       && ! do_types)
@@ -2492,6 +2586,9 @@ process_debug_info (struct dwarf_section *section,
 	  continue;
 	}
 
+      if (do_loc && debug_info_headers_only)
+	continue;
+
       free_abbrevs ();
 
       /* Process the abbrevs used by this compilation unit.  */
@@ -2590,12 +2687,7 @@ process_debug_info (struct dwarf_section *section,
 		}
 	    }
 
-	  /* Scan through the abbreviation list until we reach the
-	     correct entry.  */
-	  for (entry = first_abbrev;
-	       entry && entry->entry != abbrev_number;
-	       entry = entry->next)
-	    continue;
+	  entry = find_abbrev (abbrev_number);
 
 	  if (entry == NULL)
 	    {
@@ -2700,7 +2792,7 @@ load_debug_info (void * file)
     return 0;
 
   /* If we already have the information there is nothing else to do.  */
-  if (num_debug_info_entries > 0)
+  if (num_debug_info_entries > 0 && ! debug_info_headers_only)
     return num_debug_info_entries;
 
   /* If this is a DWARF package file, load the CU and TU indexes.  */
@@ -2719,6 +2811,42 @@ load_debug_info (void * file)
   return 0;
 }
 
+/* Like load_debug_info, but only record the offsets, pointer sizes
+   and versions of the compilation units, without decoding their DIEs.
+   This is all that is needed to check references to .debug_info from
+   sections such as .debug_aranges and .debug_pubnames.  The index is
+   replaced by the full information if that is needed later on.  */
+
+static unsigned int
+load_debug_info_headers (void * file)
+{
+  last_pointer_size = 0;
+  warned_about_missing_comp_units = FALSE;
+
+  if (num_debug_info_entries == DEBUG_INFO_UNAVAILABLE)
+    return 0;
+
+  if (num_debug_info_entries > 0)
+    return num_debug_info_entries;
+
+  load_cu_tu_indexes (file);
+
+  debug_info_headers_only = TRUE;
+
+  if (load_debug_section (info, file)
+      && process_debug_info (&debug_displays [info].section, file, abbrev, 1, 0))
+    return num_debug_info_entries;
+
+  if (load_debug_section (info_dwo, file)
+      && process_debug_info (&debug_displays [info_dwo].section, file,
+			     abbrev_dwo, 1, 0))
+    return num_debug_info_entries;
+
+  debug_info_headers_only = FALSE;
+  num_debug_info_entries = DEBUG_INFO_UNAVAILABLE;
+  return 0;
+}
+
 /* Read a DWARF .debug_line section header starting at DATA.
    Upon success returns an updated DATA pointer and the LINFO
    structure and the END_OF_SEQUENCE pointer will be filled in.
@@ -3674,14 +3802,26 @@ display_debug_lines (struct dwarf_section *section, void *file ATTRIBUTE_UNUSED)
 static debug_info *
 find_debug_info_for_offset (unsigned long offset)
 {
-  unsigned int i;
+  unsigned int lo, hi;
 
   if (num_debug_info_entries == DEBUG_INFO_UNAVAILABLE)
     return NULL;
 
-  for (i = 0; i < num_debug_info_entries; i++)
-    if (debug_information[i].cu_offset == offset)
-      return debug_information + i;
+  /* The units are recorded in section order, so their offsets are
+     increasing.  */
+  lo = 0;
+  hi = num_debug_info_entries;
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      if (debug_information[mid].cu_offset < offset)
+	lo = mid + 1;
+      else if (debug_information[mid].cu_offset > offset)
+	hi = mid;
+      else
+	return debug_information + mid;
+    }
 
   return NULL;
 }
@@ -3716,7 +3856,7 @@ display_debug_pubnames_worker (struct dwarf_section *section,
 
   /* It does not matter if this load fails,
      we test for that later on.  */
-  load_debug_info (file);
+  load_debug_info_headers (file);
 
   printf (_("Contents of the %s section:\n\n"), section->name);
 
@@ -4835,7 +4975,7 @@ display_debug_aranges (struct dwarf_section *section,
 
   /* It does not matter if this load fails,
      we test for that later on.  */
-  load_debug_info (file);
+  load_debug_info_headers (file);
 
   while (start < end)
     {
@@ -7332,6 +7472,9 @@ free_debug_memory (void)
   unsigned int i;
 
   free_abbrevs ();
+  free (abbrev_lookup);
+  abbrev_lookup = NULL;
+  abbrev_lookup_size = 0;
 
   for (i = 0; i < max; i++)
     free_debug_section ((enum dwarf_section_display_enum) i);
@@ -7355,6 +7498,7 @@ free_debug_memory (void)
       debug_information = NULL;
       alloc_num_debug_info_entries = num_debug_info_entries = 0;
     }
+  debug_info_headers_only = FALSE;
 }
 
 void
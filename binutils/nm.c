@@ -363,7 +363,8 @@ print_symname (const char *form, const char *name, bfd *abfd)
 {
   if (do_demangle && *name)
     {
-      char *res = bfd_demangle (abfd, name, DMGL_ANSI | DMGL_PARAMS);
+      char *res = cached_demangle (bfd_demangle, abfd, name,
+				   DMGL_ANSI | DMGL_PARAMS);
 
       if (res != NULL)
 	{
@@ -37,6 +37,10 @@
 #include "coff/i386.h"
 #include "coff/pe.h"
 
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+#include <sys/wait.h>
+#endif
+
 static bfd_vma pe_file_alignment = (bfd_vma) -1;
 static bfd_vma pe_heap_commit = (bfd_vma) -1;
 static bfd_vma pe_heap_reserve = (bfd_vma) -1;
@@ -83,6 +87,7 @@ static int interleave = 0; /* Initialised to 4 in copy_main().  */
 static int copy_width = 1;
 
 static bfd_boolean verbose;		/* Print file and target names.  */
+static int strip_jobs = 1;		/* Files that strip works on at once.  */
 static bfd_boolean preserve_dates;	/* Preserve input file timestamp.  */
 static int deterministic = -1;		/* Enable deterministic archives.  */
 static int status = 0;		/* Exit status.  */
@@ -319,7 +324,8 @@ enum command_line_switch
     OPTION_INTERLEAVE_WIDTH,
     OPTION_SUBSYSTEM,
     OPTION_EXTRACT_DWO,
-    OPTION_STRIP_DWO
+    OPTION_STRIP_DWO,
+    OPTION_JOBS
   };
 
 /* Options to handle if running as "strip".  */
@@ -335,6 +341,7 @@ static struct option strip_options[] =
   {"info", no_argument, 0, OPTION_FORMATS_INFO},
   {"input-format", required_argument, 0, 'I'}, /* Obsolete */
   {"input-target", required_argument, 0, 'I'},
+  {"jobs", required_argument, 0, OPTION_JOBS},
   {"keep-file-symbols", no_argument, 0, OPTION_KEEP_FILE_SYMBOLS},
   {"keep-symbol", required_argument, 0, 'K'},
   {"only-keep-debug", no_argument, 0, OPTION_ONLY_KEEP_DEBUG},
@@ -645,6 +652,7 @@ strip_usage (FILE *stream, int exit_status)
   -x --discard-all                 Remove all non-global symbols\n\
   -X --discard-locals              Remove any compiler-generated symbols\n\
   -v --verbose                     List all object files modified\n\
+     --jobs=<number>               Strip up to <number> files at once\n\
   -V --version                     Display this program's version number\n\
   -h --help                        Display this output\n\
      --info                        List object formats & architectures supported\n\
@@ -1644,6 +1652,7 @@ copy_object (bfd *ibfd, bfd *obfd, const bfd_arch_info_type *input_arch)
   if (bfd_get_format (obfd) != bfd_core)
     {
       flagword flags;
+      flagword in_memory = obfd->flags & BFD_IN_MEMORY;
 
       flags = bfd_get_file_flags (ibfd);
       flags |= bfd_flags_to_set;
@@ -1659,6 +1668,10 @@ copy_object (bfd *ibfd, bfd *obfd, const bfd_arch_info_type *input_arch)
 	  bfd_nonfatal_message (NULL, ibfd, NULL, NULL);
 	  return FALSE;
 	}
+
+      /* bfd_set_file_flags replaces all the flags, but an archive
+	 member that copy_archive writes to memory must stay there.  */
+      obfd->flags |= in_memory;
     }
 
   /* Copy architecture of input file to output file.  */
@@ -2245,8 +2258,13 @@ copy_object (bfd *ibfd, bfd *obfd, const bfd_arch_info_type *input_arch)
   return TRUE;
 }
 
+/* The most memory, in bytes, that copy_archive uses to hold copied
+   archive members, rather than writing them to temporary files.  */
+
+#define ARCHIVE_IN_MEMORY_LIMIT (64 * 1024 * 1024)
+
 /* Read each archive element in turn from IBFD, copy the
-   contents to temp file, and keep the temp file handle.
+   contents to memory or a temp file, and keep the handle.
    If 'force_output_target' is TRUE then make sure that
    all elements in the new archive are of the type
    'output_target'.  */
@@ -2266,6 +2284,7 @@ copy_archive (bfd *ibfd, bfd *obfd, const char *output_target,
   bfd *this_element;
   char *dir;
   const char *filename;
+  bfd_size_type in_memory_size = 0;
 
   /* Make a temp directory to hold the contents.  */
   dir = make_tempdir (bfd_get_filename (obfd));
@@ -2302,6 +2321,7 @@ copy_archive (bfd *ibfd, bfd *obfd, const char *output_target,
       int stat_status = 0;
       bfd_boolean del = TRUE;
       bfd_boolean ok_object;
+      bfd_boolean in_memory;
 
       /* PR binutils/17533: Do not allow directory traversal
 	 outside of the current directory tree by archive members.  */
@@ -2313,12 +2333,31 @@ copy_archive (bfd *ibfd, bfd *obfd, const char *output_target,
 	  goto cleanup_and_exit;
 	}
 
+      ok_object = bfd_check_format (this_element, bfd_object);
+      if (!ok_object)
+	bfd_nonfatal_message (NULL, this_element, NULL,
+			      _("Unable to recognise the format of file"));
+
+      /* Copy objects whose copies can be added to the output archive
+	 straight from memory there, rather than through a temporary
+	 file, until they would take too much memory.  Objects of an
+	 unknown architecture might have to be copied as unknown files
+	 instead, which needs a file.  */
+      in_memory = (ok_object
+		   && !bfd_is_thin_archive (obfd)
+		   && bfd_get_arch (this_element) != bfd_arch_unknown
+		   && (in_memory_size + arelt_size (this_element)
+		       <= ARCHIVE_IN_MEMORY_LIMIT));
+
       /* Create an output file for this member.  */
-      output_name = concat (dir, "/",
-			    bfd_get_filename (this_element), (char *) 0);
+      if (in_memory)
+	output_name = xstrdup (bfd_get_filename (this_element));
+      else
+	output_name = concat (dir, "/",
+			      bfd_get_filename (this_element), (char *) 0);
 
       /* If the file already exists, make another temp dir.  */
-      if (stat (output_name, &buf) >= 0)
+      if (!in_memory && stat (output_name, &buf) >= 0)
 	{
 	  output_name = make_tempdir (output_name);
 	  if (output_name == NULL)
@@ -2348,19 +2387,26 @@ copy_archive (bfd *ibfd, bfd *obfd, const char *output_target,
 	}
 
       l = (struct name_list *) xmalloc (sizeof (struct name_list));
-      l->name = output_name;
+      l->name = in_memory ? NULL : output_name;
       l->next = list;
       l->obfd = NULL;
       list = l;
 
-      ok_object = bfd_check_format (this_element, bfd_object);
-      if (!ok_object)
-	bfd_nonfatal_message (NULL, this_element, NULL,
-			      _("Unable to recognise the format of file"));
-
       /* PR binutils/3110: Cope with archives
 	 containing multiple target types.  */
-      if (force_output_target || !ok_object)
+      if (in_memory)
+	{
+	  output_bfd = bfd_create (output_name, this_element);
+	  if (output_bfd != NULL
+	      && ((force_output_target
+		   && bfd_find_target (output_target, output_bfd) == NULL)
+		  || !bfd_make_writable (output_bfd)))
+	    {
+	      bfd_close_all_done (output_bfd);
+	      output_bfd = NULL;
+	    }
+	}
+      else if (force_output_target || !ok_object)
 	output_bfd = bfd_openw (output_name, output_target);
       else
 	output_bfd = bfd_openw (output_name, bfd_get_target (this_element));
@@ -2376,7 +2422,22 @@ copy_archive (bfd *ibfd, bfd *obfd, const char *output_target,
 	{
 	  del = !copy_object (this_element, output_bfd, input_arch);
 
-	  if (del && bfd_get_arch (this_element) == bfd_arch_unknown)
+	  if (in_memory)
+	    {
+	      /* Write the contents to memory, ready to be read back
+		 when the output archive is written.  */
+	      if (del)
+		bfd_close_all_done (output_bfd);
+	      else if (!bfd_make_readable (output_bfd))
+		{
+		  bfd_nonfatal_message (output_name, NULL, NULL, NULL);
+		  bfd_close_all_done (output_bfd);
+		  del = TRUE;
+		}
+	      else
+		in_memory_size += bfd_get_size (output_bfd);
+	    }
+	  else if (del && bfd_get_arch (this_element) == bfd_arch_unknown)
 	    /* Try again as an unknown object file.  */
 	    ok_object = FALSE;
 	  else if (!bfd_close (output_bfd))
@@ -2400,16 +2461,28 @@ copy_archive (bfd *ibfd, bfd *obfd, const char *output_target,
 
       if (del)
 	{
-	  unlink (output_name);
+	  if (!in_memory)
+	    unlink (output_name);
 	  status = 1;
 	}
       else
 	{
-	  if (preserve_dates && stat_status == 0)
-	    set_times (output_name, &buf);
+	  if (in_memory)
+	    {
+	      if (preserve_dates && stat_status == 0)
+		{
+		  output_bfd->mtime = buf.st_mtime;
+		  output_bfd->mtime_set = TRUE;
+		}
+	    }
+	  else
+	    {
+	      if (preserve_dates && stat_status == 0)
+		set_times (output_name, &buf);
 
-	  /* Open the newly output file and attach to our list.  */
-	  output_bfd = bfd_openr (output_name, output_target);
+	      /* Open the newly output file and attach to our list.  */
+	      output_bfd = bfd_openr (output_name, output_target);
+	    }
 
 	  l->obfd = output_bfd;
 
@@ -2422,6 +2495,9 @@ copy_archive (bfd *ibfd, bfd *obfd, const char *output_target,
 
 	  bfd_close (last_element);
 	}
+
+      if (in_memory)
+	free (output_name);
     }
   *ptr = NULL;
 
@@ -2444,11 +2520,15 @@ copy_archive (bfd *ibfd, bfd *obfd, const char *output_target,
   for (l = list; l != NULL; l = l->next)
     {
       if (l->obfd == NULL)
-	rmdir (l->name);
+	{
+	  if (l->name != NULL)
+	    rmdir (l->name);
+	}
       else
 	{
 	  bfd_close (l->obfd);
-	  unlink (l->name);
+	  if (l->name != NULL)
+	    unlink (l->name);
 	}
     }
   rmdir (dir);
@@ -2981,6 +3061,48 @@ copy_relocations_in_section (bfd *ibfd, sec_ptr isection, void *obfdarg)
     }
 }
 
+/* Sections bigger than this that are copied unchanged are copied a
+   piece at a time, so that memory use does not grow with their size.  */
+
+#define COPY_SECTION_CHUNK_SIZE (1024 * 1024)
+
+/* Copy the SIZE bytes of contents of ISECTION of IBFD unchanged to
+   OSECTION of OBFD, COPY_SECTION_CHUNK_SIZE bytes at a time.  Returns
+   FALSE, having reported the error, on failure.  */
+
+static bfd_boolean
+copy_section_in_chunks (bfd *ibfd, sec_ptr isection,
+			bfd *obfd, sec_ptr osection, bfd_size_type size)
+{
+  bfd_byte *buf = (bfd_byte *) xmalloc (COPY_SECTION_CHUNK_SIZE);
+  bfd_size_type offset;
+
+  for (offset = 0; offset < size; offset += COPY_SECTION_CHUNK_SIZE)
+    {
+      bfd_size_type count = size - offset;
+
+      if (count > COPY_SECTION_CHUNK_SIZE)
+	count = COPY_SECTION_CHUNK_SIZE;
+
+      if (!bfd_get_section_contents (ibfd, isection, buf, offset, count))
+	{
+	  bfd_nonfatal_message (NULL, ibfd, isection, NULL);
+	  free (buf);
+	  return FALSE;
+	}
+
+      if (!bfd_set_section_contents (obfd, osection, buf, offset, count))
+	{
+	  bfd_nonfatal_message (NULL, obfd, osection, NULL);
+	  free (buf);
+	  return FALSE;
+	}
+    }
+
+  free (buf);
+  return TRUE;
+}
+
 /* Copy the data of input section ISECTION of IBFD
    to an output section with the same name in OBFD.  */
 
@@ -3003,6 +3125,21 @@ copy_section (bfd *ibfd, sec_ptr isection, void *obfdarg)
     {
       bfd_byte *memhunk = NULL;
 
+      /* Big sections that are neither transformed here nor compressed
+	 or decompressed on the way are streamed to an ELF output file,
+	 whose backends accept the contents of a section in pieces.  */
+      if (size > COPY_SECTION_CHUNK_SIZE
+	  && reverse_bytes == 0
+	  && copy_byte < 0
+	  && isection->compress_status == COMPRESS_SECTION_NONE
+	  && (isection->rawsize == 0 || isection->rawsize == size)
+	  && bfd_get_flavour (obfd) == bfd_target_elf_flavour)
+	{
+	  if (!copy_section_in_chunks (ibfd, isection, obfd, osection, size))
+	    status = 1;
+	  return;
+	}
+
       if (!bfd_get_full_section_contents (ibfd, isection, &memhunk))
 	{
 	  status = 1;
@@ -3259,6 +3396,179 @@ default_deterministic (void)
     deterministic = DEFAULT_AR_DETERMINISTIC;
 }
 
+/* Strip FILE in place, or into OUTPUT_FILE if that is not NULL.
+   Returns nonzero on failure.  */
+
+static int
+strip_file (char *file, char *output_file,
+	    const char *input_target, const char *output_target)
+{
+  struct stat statbuf;
+  char *tmpname;
+
+  if (get_file_size (file) < 1)
+    return 1;
+
+  if (preserve_dates)
+    /* No need to check the return value of stat().
+       It has already been checked in get_file_size().  */
+    stat (file, &statbuf);
+
+  if (output_file == NULL
+      || filename_cmp (file, output_file) == 0)
+    tmpname = make_tempname (file);
+  else
+    tmpname = output_file;
+
+  if (tmpname == NULL)
+    {
+      bfd_nonfatal_message (file, NULL, NULL,
+			    _("could not create temporary file to hold stripped copy"));
+      return 1;
+    }
+
+  status = 0;
+  copy_file (file, tmpname, input_target, output_target, NULL);
+  if (status == 0)
+    {
+      if (preserve_dates)
+	set_times (tmpname, &statbuf);
+      if (output_file != tmpname)
+	status = (smart_rename (tmpname,
+				output_file ? output_file : file,
+				preserve_dates) != 0);
+    }
+  else
+    unlink_if_ordinary (tmpname);
+  if (output_file != tmpname)
+    free (tmpname);
+
+  return status;
+}
+
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+/* The identity of a file to be stripped by strip_files_in_parallel.  */
+
+struct strip_file_id
+{
+  dev_t dev;
+  ino_t ino;
+};
+
+static int
+compare_strip_file_ids (const void *a, const void *b)
+{
+  const struct strip_file_id *id1 = (const struct strip_file_id *) a;
+  const struct strip_file_id *id2 = (const struct strip_file_id *) b;
+
+  if (id1->dev != id2->dev)
+    return id1->dev < id2->dev ? -1 : 1;
+  if (id1->ino != id2->ino)
+    return id1->ino < id2->ino ? -1 : 1;
+  return 0;
+}
+
+/* Return TRUE if no file is named twice among the NFILES files in
+   FILES, whether by the same name or another.  Two processes writing
+   the same file would race to rename their results over it.  */
+
+static bfd_boolean
+strip_files_distinct_p (char **files, int nfiles)
+{
+  struct strip_file_id *ids;
+  int n = 0;
+  int i;
+  bfd_boolean ret = TRUE;
+
+  ids = (struct strip_file_id *) xmalloc (nfiles * sizeof (*ids));
+  for (i = 0; i < nfiles; i++)
+    {
+      struct stat st;
+
+      /* A file that cannot be found is reported by strip_file.  */
+      if (stat (files[i], &st) == 0)
+	{
+	  ids[n].dev = st.st_dev;
+	  ids[n].ino = st.st_ino;
+	  n++;
+	}
+    }
+
+  qsort (ids, n, sizeof (*ids), compare_strip_file_ids);
+  for (i = 1; i < n; i++)
+    if (compare_strip_file_ids (&ids[i - 1], &ids[i]) == 0)
+      {
+	ret = FALSE;
+	break;
+      }
+
+  free (ids);
+  return ret;
+}
+
+/* Strip the NFILES files in FILES in place, in up to strip_jobs child
+   processes at once.  Each file is written by a single process, so
+   the results are the same as stripping the files one after another.
+   Returns nonzero if any failed.  */
+
+static int
+strip_files_in_parallel (char **files, int nfiles,
+			 const char *input_target, const char *output_target)
+{
+  int running = 0;
+  int ret = 0;
+  int i = 0;
+
+  while (i < nfiles || running > 0)
+    {
+      pid_t pid;
+      int wstatus;
+
+      if (i < nfiles && running < strip_jobs)
+	{
+	  /* Do not let the child write out what is buffered here.  */
+	  fflush (stdout);
+	  fflush (stderr);
+
+	  pid = fork ();
+	  if (pid == 0)
+	    {
+	      int file_status;
+
+	      file_status = strip_file (files[i], NULL,
+					input_target, output_target);
+	      fflush (stdout);
+	      fflush (stderr);
+	      _exit (file_status);
+	    }
+
+	  if (pid < 0)
+	    /* Strip the file here instead.  */
+	    ret |= strip_file (files[i], NULL, input_target, output_target);
+	  else
+	    running++;
+	  i++;
+	  continue;
+	}
+
+      pid = waitpid (-1, &wstatus, 0);
+      if (pid < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  non_fatal (_("waitpid failed: %s"), strerror (errno));
+	  return 1;
+	}
+
+      running--;
+      if (!WIFEXITED (wstatus) || WEXITSTATUS (wstatus) != 0)
+	ret = 1;
+    }
+
+  return ret;
+}
+#endif
+
 static int
 strip_main (int argc, char *argv[])
 {
@@ -3341,6 +3651,15 @@ strip_main (int argc, char *argv[])
 	case OPTION_KEEP_FILE_SYMBOLS:
 	  keep_file_symbols = 1;
 	  break;
+	case OPTION_JOBS:
+	  {
+	    char *end;
+
+	    strip_jobs = (int) strtol (optarg, &end, 0);
+	    if (*end != '\0' || strip_jobs < 1)
+	      fatal (_("invalid number of jobs: %s"), optarg);
+	  }
+	  break;
 	case 0:
 	  /* We've been given a long option.  */
 	  break;
@@ -3380,54 +3699,25 @@ strip_main (int argc, char *argv[])
       || (output_file != NULL && (i + 1) < argc))
     strip_usage (stderr, 1);
 
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+  /* A file named more than once is stripped once for each time, one
+     after another, as without --jobs.  */
+  if (strip_jobs > 1 && output_file == NULL && i + 1 < argc
+      && strip_files_distinct_p (argv + i, argc - i))
+    {
+      status = strip_files_in_parallel (argv + i, argc - i,
+					input_target, output_target);
+      return status;
+    }
+#endif
+
   for (; i < argc; i++)
     {
       int hold_status = status;
-      struct stat statbuf;
-      char *tmpname;
 
-      if (get_file_size (argv[i]) < 1)
-	{
-	  status = 1;
-	  continue;
-	}
-
-      if (preserve_dates)
-	/* No need to check the return value of stat().
-	   It has already been checked in get_file_size().  */
-	stat (argv[i], &statbuf);
-
-      if (output_file == NULL
-	  || filename_cmp (argv[i], output_file) == 0)
-	tmpname = make_tempname (argv[i]);
-      else
-	tmpname = output_file;
-
-      if (tmpname == NULL)
-	{
-	  bfd_nonfatal_message (argv[i], NULL, NULL,
-				_("could not create temporary file to hold stripped copy"));
-	  status = 1;
-	  continue;
-	}
-
-      status = 0;
-      copy_file (argv[i], tmpname, input_target, output_target, NULL);
+      status = strip_file (argv[i], output_file, input_target, output_target);
       if (status == 0)
-	{
-	  if (preserve_dates)
-	    set_times (tmpname, &statbuf);
-	  if (output_file != tmpname)
-	    status = (smart_rename (tmpname,
-				    output_file ? output_file : argv[i],
-				    preserve_dates) != 0);
-	  if (status == 0)
-	    status = hold_status;
-	}
-      else
-	unlink_if_ordinary (tmpname);
-      if (output_file != tmpname)
-	free (tmpname);
+	status = hold_status;
     }
 
   return status;
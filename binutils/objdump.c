@@ -802,7 +802,8 @@ objdump_print_symname (bfd *abfd, struct disassemble_info *inf,
   if (do_demangle && name[0] != '\0')
     {
       /* Demangle the name.  */
-      alloc = bfd_demangle (abfd, name, DMGL_ANSI | DMGL_PARAMS);
+      alloc = cached_demangle (bfd_demangle, abfd, name,
+			       DMGL_ANSI | DMGL_PARAMS);
       if (alloc != NULL)
 	name = alloc;
     }
@@ -1449,7 +1450,24 @@ typedef struct
   size_t alloc;
 } SFILE;
 
-/* sprintf to a "stream".  */
+/* Append LEN bytes of TEXT to the "stream" F.  */
+
+static void
+objdump_sappend (SFILE *f, const char *text, size_t len)
+{
+  if (f->alloc - f->pos <= len)
+    {
+      f->alloc = (f->alloc + len) * 2;
+      f->buffer = (char *) xrealloc (f->buffer, f->alloc);
+    }
+  memcpy (f->buffer + f->pos, text, len);
+  f->pos += len;
+  f->buffer[f->pos] = '\0';
+}
+
+/* sprintf to a "stream".  Most of the disassemblers print operands
+   and mnemonics with a plain "%s" or "%c", so handle those without
+   going through vsnprintf.  */
 
 static int ATTRIBUTE_PRINTF_2
 objdump_sprintf (SFILE *f, const char *format, ...)
@@ -1457,6 +1475,36 @@ objdump_sprintf (SFILE *f, const char *format, ...)
   size_t n;
   va_list args;
 
+  if (format[0] == '%' && format[1] != '\0' && format[2] == '\0')
+    {
+      if (format[1] == 's')
+	{
+	  const char *text;
+
+	  va_start (args, format);
+	  text = va_arg (args, const char *);
+	  va_end (args);
+	  /* Leave a NULL string to vsnprintf, which prints it as
+	     "(null)" with glibc.  */
+	  if (text != NULL)
+	    {
+	      n = strlen (text);
+	      objdump_sappend (f, text, n);
+	      return n;
+	    }
+	}
+      if (format[1] == 'c')
+	{
+	  char c;
+
+	  va_start (args, format);
+	  c = (char) va_arg (args, int);
+	  va_end (args);
+	  objdump_sappend (f, &c, 1);
+	  return 1;
+	}
+    }
+
   while (1)
     {
       size_t space = f->alloc - f->pos;
@@ -1476,6 +1524,26 @@ objdump_sprintf (SFILE *f, const char *format, ...)
   return n;
 }
 
+/* Print the BPC octets at DATA in hex, followed by a space.  If
+   REVERSE, print them from last to first.  This is called for every
+   octet that is disassembled, so avoid printf.  */
+
+static void
+print_raw_octets (const bfd_byte *data, int bpc, bfd_boolean reverse)
+{
+  static const char hex[] = "0123456789abcdef";
+  int k;
+
+  for (k = 0; k < bpc; k++)
+    {
+      unsigned int octet = data[reverse ? bpc - 1 - k : k];
+
+      putchar (hex[octet >> 4]);
+      putchar (hex[octet & 0xf]);
+    }
+  putchar (' ');
+}
+
 /* The number of zeroes we want to see before we start skipping them.
    The number is arbitrarily chosen.  */
 
@@ -1616,7 +1684,8 @@ disassemble_bytes (struct disassemble_info * inf,
 		*s = ' ';
 	      if (*s == '\0')
 		*--s = '0';
-	      printf ("%s:\t", buf + skip_addr_chars);
+	      fputs (buf + skip_addr_chars, stdout);
+	      fputs (":\t", stdout);
 	    }
 	  else
 	    {
@@ -1723,29 +1792,16 @@ disassemble_bytes (struct disassemble_info * inf,
 		bpc = 1;
 
 	      for (j = addr_offset * opb; j < addr_offset * opb + pb; j += bpc)
-		{
-		  int k;
-
-		  if (bpc > 1 && inf->display_endian == BFD_ENDIAN_LITTLE)
-		    {
-		      for (k = bpc - 1; k >= 0; k--)
-			printf ("%02x", (unsigned) data[j + k]);
-		      putchar (' ');
-		    }
-		  else
-		    {
-		      for (k = 0; k < bpc; k++)
-			printf ("%02x", (unsigned) data[j + k]);
-		      putchar (' ');
-		    }
-		}
+		print_raw_octets (data + j, bpc,
+				  (bpc > 1
+				   && inf->display_endian == BFD_ENDIAN_LITTLE));
 
 	      for (; pb < octets_per_line; pb += bpc)
 		{
 		  int k;
 
 		  for (k = 0; k < bpc; k++)
-		    printf ("  ");
+		    fputs ("  ", stdout);
 		  putchar (' ');
 		}
 
@@ -1753,13 +1809,13 @@ disassemble_bytes (struct disassemble_info * inf,
 	      if (insns)
 		putchar ('\t');
 	      else
-		printf ("    ");
+		fputs ("    ", stdout);
 	    }
 
 	  if (! insns)
-	    printf ("%s", buf);
+	    fputs (buf, stdout);
 	  else if (sfile.pos)
-	    printf ("%s", sfile.buffer);
+	    fputs (sfile.buffer, stdout);
 
 	  if (prefix_addresses
 	      ? show_raw_insn > 0
@@ -1778,28 +1834,16 @@ disassemble_bytes (struct disassemble_info * inf,
 		    *s = ' ';
 		  if (*s == '\0')
 		    *--s = '0';
-		  printf ("%s:\t", buf + skip_addr_chars);
+		  fputs (buf + skip_addr_chars, stdout);
+		  fputs (":\t", stdout);
 
 		  pb += octets_per_line;
 		  if (pb > octets)
 		    pb = octets;
 		  for (; j < addr_offset * opb + pb; j += bpc)
-		    {
-		      int k;
-
-		      if (bpc > 1 && inf->display_endian == BFD_ENDIAN_LITTLE)
-			{
-			  for (k = bpc - 1; k >= 0; k--)
-			    printf ("%02x", (unsigned) data[j + k]);
-			  putchar (' ');
-			}
-		      else
-			{
-			  for (k = 0; k < bpc; k++)
-			    printf ("%02x", (unsigned) data[j + k]);
-			  putchar (' ');
-			}
-		    }
+		    print_raw_octets (data + j, bpc,
+				      (bpc > 1
+				       && inf->display_endian == BFD_ENDIAN_LITTLE));
 		}
 	    }
 
@@ -1892,6 +1936,8 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
   unsigned int                 opb = pinfo->octets_per_byte;
   bfd_byte *                   data = NULL;
   bfd_size_type                datasize = 0;
+  void *                       map_addr;
+  bfd_size_type                map_len;
   arelent **                   rel_pp = NULL;
   arelent **                   rel_ppstart = NULL;
   arelent **                   rel_ppend;
@@ -1978,9 +2024,14 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
     }
   rel_ppend = rel_pp + rel_count;
 
-  data = (bfd_byte *) xmalloc (datasize);
-
-  bfd_get_section_contents (abfd, section, data, 0, datasize);
+  if (!bfd_map_section_contents (abfd, section, &data, &map_addr, &map_len))
+    {
+      non_fatal (_("Reading section %s failed because: %s"),
+		 section->name, bfd_errmsg (bfd_get_error ()));
+      if (rel_ppstart != NULL)
+	free (rel_ppstart);
+      return;
+    }
 
   paux->sec = section;
   pinfo->buffer = data;
@@ -2115,7 +2166,7 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
       sym = nextsym;
     }
 
-  free (data);
+  bfd_unmap_section_contents (data, map_addr, map_len);
 
   if (rel_ppstart != NULL)
     free (rel_ppstart);
@@ -2250,6 +2301,13 @@ disassemble_data (bfd *abfd)
   free (sorted_syms);
 }
 
+/* The mmap()ed regions, if any, backing the loaded debug sections.  */
+static struct
+{
+  void *addr;
+  bfd_size_type len;
+} debug_section_maps[max];
+
 static int
 load_specific_debug_section (enum dwarf_section_display_enum debug,
 			     asection *sec, void *file)
@@ -2266,7 +2324,14 @@ load_specific_debug_section (enum dwarf_section_display_enum debug,
   section->size = bfd_get_section_size (sec);
   section->start = NULL;
   section->user_data = sec;
-  ret = bfd_get_full_section_contents (abfd, sec, &section->start);
+  if (is_relocatable && debug_displays [debug].relocate)
+    ret = bfd_get_full_section_contents (abfd, sec, &section->start);
+  else
+    /* No relocations need applying, so the contents can be used
+       straight from the file.  */
+    ret = bfd_map_section_contents (abfd, sec, &section->start,
+				    &debug_section_maps[debug].addr,
+				    &debug_section_maps[debug].len);
 
   if (! ret)
     {
@@ -2349,7 +2414,15 @@ free_debug_section (enum dwarf_section_display_enum debug)
 	}
     }
 
-  free ((char *) section->start);
+  if (debug_section_maps[debug].addr != NULL)
+    {
+      bfd_unmap_section_contents (section->start,
+				  debug_section_maps[debug].addr,
+				  debug_section_maps[debug].len);
+      debug_section_maps[debug].addr = NULL;
+    }
+  else
+    free ((char *) section->start);
   section->start = NULL;
   section->address = 0;
   section->size = 0;
@@ -2733,6 +2806,8 @@ static void
 dump_section (bfd *abfd, asection *section, void *dummy ATTRIBUTE_UNUSED)
 {
   bfd_byte *data = 0;
+  void *map_addr;
+  bfd_size_type map_len;
   bfd_size_type datasize;
   bfd_size_type addr_offset;
   bfd_size_type start_offset;
@@ -2782,7 +2857,7 @@ dump_section (bfd *abfd, asection *section, void *dummy ATTRIBUTE_UNUSED)
 	    (unsigned long) (section->filepos + start_offset));
   printf ("\n");
 
-  if (!bfd_get_full_section_contents (abfd, section, &data))
+  if (!bfd_map_section_contents (abfd, section, &data, &map_addr, &map_len))
     {
       non_fatal (_("Reading section %s failed because: %s"),
 		 section->name, bfd_errmsg (bfd_get_error ()));
@@ -2854,7 +2929,7 @@ dump_section (bfd *abfd, asection *section, void *dummy ATTRIBUTE_UNUSED)
 	}
       putchar ('\n');
     }
-  free (data);
+  bfd_unmap_section_contents (data, map_addr, map_len);
 }
 
 /* Actually display the various requested regions.  */
@@ -2914,7 +2989,8 @@ dump_symbols (bfd *abfd ATTRIBUTE_UNUSED, bfd_boolean dynamic)
 	      /* If we want to demangle the name, we demangle it
 		 here, and temporarily clobber it while calling
 		 bfd_print_symbol.  FIXME: This is a gross hack.  */
-	      alloc = bfd_demangle (cur_bfd, name, DMGL_ANSI | DMGL_PARAMS);
+	      alloc = cached_demangle (bfd_demangle, cur_bfd, name,
+				       DMGL_ANSI | DMGL_PARAMS);
 	      if (alloc != NULL)
 		(*current)->name = alloc;
 	      bfd_print_symbol (cur_bfd, stdout, *current,
@@ -49,6 +49,9 @@
 #ifdef HAVE_WCHAR_H
 #include <wchar.h>
 #endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 
 #if __GNUC__ >= 2
 /* Define BFD64 here, even if our default architecture is 32 bit ELF
@@ -390,6 +393,81 @@ get_data (void * var, FILE * file, unsigned long offset, bfd_size_type size,
   return mvar;
 }
 
+/* Like get_data (NULL, FILE, OFFSET, 1, SIZE, REASON), but if possible
+   return a pointer into a private mapping of the file instead of
+   reading the data into a freshly allocated buffer.  The mapping is
+   writable, so that relocations can be applied to the data in place.
+   *MAP_ADDR and *MAP_LEN are set to describe the mapping, or *MAP_ADDR
+   to NULL if the data was copied.  Release the data with
+   release_mapped_data.  */
+
+static void *
+get_mapped_data (FILE * file, unsigned long offset, bfd_size_type size,
+		 void ** map_addr, size_t * map_len, const char * reason)
+{
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  static unsigned long pagesize;
+  unsigned long where = archive_file_offset + offset;
+  struct stat statbuf;
+
+  if (pagesize == 0)
+    pagesize = getpagesize ();
+
+  /* Small sections are not worth a mapping of their own.  FILE may be
+     a member of a thin archive rather than the file whose size is
+     current_file_size, so check against its own size: touching a
+     mapping beyond the end of the file would raise SIGBUS.  */
+  if (size > 4 * pagesize
+      && (bfd_size_type) ((size_t) size) == size
+      && where >= offset
+      && fstat (fileno (file), &statbuf) == 0
+      && size <= (bfd_size_type) statbuf.st_size
+      && where + size <= (bfd_size_type) statbuf.st_size)
+    {
+      unsigned long map_start = where & ~(pagesize - 1);
+      size_t len = where + size - map_start;
+      void * addr;
+
+      addr = mmap (NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+		   fileno (file), map_start);
+      if (addr != MAP_FAILED)
+	{
+	  unsigned char * data = (unsigned char *) addr + (where - map_start);
+
+	  /* get_data NUL terminates the buffers that it allocates, and
+	     some readers rely on that to stop at the end of a section.
+	     Only use the mapping if the section provides the NUL.  */
+	  if (data[size - 1] == '\0')
+	    {
+	      *map_addr = addr;
+	      *map_len = len;
+	      return data;
+	    }
+	  munmap (addr, len);
+	}
+    }
+#endif
+
+  *map_addr = NULL;
+  *map_len = 0;
+  return get_data (NULL, file, offset, 1, size, reason);
+}
+
+/* Release DATA, as returned by get_mapped_data.  */
+
+static void
+release_mapped_data (void * data, void * map_addr, size_t map_len)
+{
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  if (map_addr != NULL)
+    {
+      munmap (map_addr, map_len);
+      return;
+    }
+#endif
+  free (data);
+}
+
 /* Print a VMA value.  */
 
 static int
@@ -11480,10 +11558,13 @@ disassemble_section (Elf_Internal_Shdr * section, FILE * file)
 #endif
 
 /* Reads in the contents of SECTION from FILE, returning a pointer
-   to a malloc'ed buffer or NULL if something went wrong.  */
+   to the data or NULL if something went wrong.  The data is obtained
+   with get_mapped_data, and should be released with
+   release_mapped_data (data, *MAP_ADDR, *MAP_LEN).  */
 
 static char *
-get_section_contents (Elf_Internal_Shdr * section, FILE * file)
+get_section_contents (Elf_Internal_Shdr * section, FILE * file,
+		      void ** map_addr, size_t * map_len)
 {
   bfd_size_type num_bytes;
 
@@ -11496,8 +11577,8 @@ get_section_contents (Elf_Internal_Shdr * section, FILE * file)
       return NULL;
     }
 
-  return  (char *) get_data (NULL, file, section->sh_offset, 1, num_bytes,
-                             _("section contents"));
+  return (char *) get_mapped_data (file, section->sh_offset, num_bytes,
+				   map_addr, map_len, _("section contents"));
 }
 
 
@@ -11510,8 +11591,10 @@ dump_section_as_strings (Elf_Internal_Shdr * section, FILE * file)
   char * end;
   char * start;
   bfd_boolean some_strings_shown;
+  void * map_addr;
+  size_t map_len;
 
-  start = get_section_contents (section, file);
+  start = get_section_contents (section, file, &map_addr, &map_len);
   if (start == NULL)
     return;
 
@@ -11577,7 +11660,7 @@ dump_section_as_strings (Elf_Internal_Shdr * section, FILE * file)
   if (! some_strings_shown)
     printf (_("  No strings found in this section."));
 
-  free (start);
+  release_mapped_data (start, map_addr, map_len);
 
   putchar ('\n');
 }
@@ -11592,8 +11675,11 @@ dump_section_as_bytes (Elf_Internal_Shdr * section,
   bfd_vma addr;
   unsigned char * data;
   unsigned char * start;
+  void * map_addr;
+  size_t map_len;
 
-  start = (unsigned char *) get_section_contents (section, file);
+  start = (unsigned char *) get_section_contents (section, file,
+						  &map_addr, &map_len);
   if (start == NULL)
     return;
 
@@ -11667,12 +11753,13 @@ dump_section_as_bytes (Elf_Internal_Shdr * section,
       bytes -= lbytes;
     }
 
-  free (start);
+  release_mapped_data (start, map_addr, map_len);
 
   putchar ('\n');
 }
 
-/* Uncompresses a section that was compressed using zlib, in place.  */
+/* Uncompresses a section that was compressed using zlib, in place.
+   The caller is responsible for releasing the compressed buffer.  */
 
 static int
 uncompress_section_contents (unsigned char **buffer ATTRIBUTE_UNUSED,
@@ -11731,7 +11818,6 @@ uncompress_section_contents (unsigned char **buffer ATTRIBUTE_UNUSED,
       || strm.avail_out != 0)
     goto fail;
 
-  free (compressed_buffer);
   *buffer = uncompressed_buffer;
   *size = uncompressed_size;
   return 1;
@@ -11744,6 +11830,13 @@ uncompress_section_contents (unsigned char **buffer ATTRIBUTE_UNUSED,
 #endif  /* HAVE_ZLIB_H */
 }
 
+/* The mmap()ed regions, if any, backing the loaded debug sections.  */
+static struct
+{
+  void * addr;
+  size_t len;
+} debug_section_maps[max];
+
 static int
 load_specific_debug_section (enum dwarf_section_display_enum debug,
 			     Elf_Internal_Shdr * sec, void * file)
@@ -11757,16 +11850,25 @@ load_specific_debug_section (enum dwarf_section_display_enum debug,
 
   snprintf (buf, sizeof (buf), _("%s section data"), section->name);
   section->address = sec->sh_addr;
-  section->start = (unsigned char *) get_data (NULL, (FILE *) file,
-                                               sec->sh_offset, 1,
-                                               sec->sh_size, buf);
+  section->start = (unsigned char *)
+    get_mapped_data ((FILE *) file, sec->sh_offset, sec->sh_size,
+		     &debug_section_maps[debug].addr,
+		     &debug_section_maps[debug].len, buf);
   if (section->start == NULL)
     section->size = 0;
   else
     {
+      unsigned char * compressed = section->start;
+
       section->size = sec->sh_size;
       if (uncompress_section_contents (&section->start, &section->size))
 	sec->sh_size = section->size;
+      if (section->start != compressed)
+	{
+	  release_mapped_data (compressed, debug_section_maps[debug].addr,
+			       debug_section_maps[debug].len);
+	  debug_section_maps[debug].addr = NULL;
+	}
     }
 
   if (section->start == NULL)
@@ -11818,7 +11920,9 @@ free_debug_section (enum dwarf_section_display_enum debug)
   if (section->start == NULL)
     return;
 
-  free ((char *) section->start);
+  release_mapped_data (section->start, debug_section_maps[debug].addr,
+		       debug_section_maps[debug].len);
+  debug_section_maps[debug].addr = NULL;
   section->start = NULL;
   section->address = 0;
   section->size = 0;
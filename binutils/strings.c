@@ -141,9 +141,9 @@ typedef struct
 static void strings_a_section (bfd *, asection *, void *);
 static bfd_boolean strings_object_file (const char *);
 static bfd_boolean strings_file (char *);
+static void init_graphic_table (void);
 static void print_strings (const char *, FILE *, file_ptr, int, int, char *);
 static void usage (FILE *, int);
-static long get_char (FILE *, file_ptr *, int *, char **);
 
 int main (int, char **);
 
@@ -289,6 +289,8 @@ main (int argc, char **argv)
       usage (stderr, 1);
     }
 
+  init_graphic_table ();
+
   bfd_init ();
   set_default_bfd_target ();
 
@@ -466,67 +468,284 @@ strings_file (char *file)
   return TRUE;
 }
 
-/* Read the next character, return EOF if none available.
-   Assume that STREAM is positioned so that the next byte read
-   is at address ADDRESS in the file.
+/* The state of a scan for strings, which may be fed data in several
+   pieces.  */
 
-   If STREAM is NULL, do not read from it.
-   The caller can supply a buffer of characters
-   to be processed before the data in STREAM.
-   MAGIC is the address of the buffer and
-   MAGICCOUNT is how many characters are in it.  */
+typedef struct
+{
+  /* The name of the file being scanned.  */
+  const char *filename;
+  /* The address of the next byte to be scanned.  */
+  file_ptr address;
+  /* Stop looking for strings at this address, if nonzero.  */
+  file_ptr stop_point;
+  /* TRUE once stop_point has been reached.  */
+  bfd_boolean stopped;
+  /* The address of the current run of graphic characters.  */
+  file_ptr start;
+  /* The number of graphic characters in the current run.  Once this
+     reaches string_min the run has been printed up to its end.  */
+  int run_len;
+  /* The first string_min characters of the current run.  */
+  char *buf;
+  /* The bytes of a multibyte character split between two pieces.  */
+  unsigned char partial[4];
+  int partial_len;
+} strings_scan;
+
+/* Which bytes are graphic characters, according to STRING_ISGRAPHIC.  */
+static char graphic_table[256];
+
+static void
+init_graphic_table (void)
+{
+  int c;
+
+  for (c = 0; c < 256; c++)
+    graphic_table[c] = STRING_ISGRAPHIC (c);
+}
+
+/* Print the file name and the address of START, as requested, ahead
+   of a string.  */
+
+static void
+print_string_prefix (const char *filename, file_ptr start)
+{
+  if (print_filenames)
+    printf ("%s: ", filename);
+  if (print_addresses)
+    switch (address_radix)
+      {
+      case 8:
+#ifdef HAVE_LONG_LONG
+	if (sizeof (start) > sizeof (long))
+	  {
+# ifndef __MSVCRT__
+	    printf ("%7llo ", (unsigned long long) start);
+# else
+	    printf ("%7I64o ", (unsigned long long) start);
+# endif
+	  }
+	else
+#elif !BFD_HOST_64BIT_LONG
+	if (start != (unsigned long) start)
+	  printf ("++%7lo ", (unsigned long) start);
+	else
+#endif
+	  printf ("%7lo ", (unsigned long) start);
+	break;
+
+      case 10:
+#ifdef HAVE_LONG_LONG
+	if (sizeof (start) > sizeof (long))
+	  {
+# ifndef __MSVCRT__
+	    printf ("%7lld ", (unsigned long long) start);
+# else
+	    printf ("%7I64d ", (unsigned long long) start);
+# endif
+	  }
+	else
+#elif !BFD_HOST_64BIT_LONG
+	if (start != (unsigned long) start)
+	  printf ("++%7ld ", (unsigned long) start);
+	else
+#endif
+	  printf ("%7ld ", (long) start);
+	break;
+
+      case 16:
+#ifdef HAVE_LONG_LONG
+	if (sizeof (start) > sizeof (long))
+	  {
+# ifndef __MSVCRT__
+	    printf ("%7llx ", (unsigned long long) start);
+# else
+	    printf ("%7I64x ", (unsigned long long) start);
+# endif
+	  }
+	else
+#elif !BFD_HOST_64BIT_LONG
+	if (start != (unsigned long) start)
+	  printf ("%lx%8.8lx ", (unsigned long) (start >> 32),
+		  (unsigned long) (start & 0xffffffff));
+	else
+#endif
+	  printf ("%7lx ", (unsigned long) start);
+	break;
+      }
+}
+
+/* Return the multibyte character whose encoding_bytes bytes are at P.  */
 
-static long
-get_char (FILE *stream, file_ptr *address, int *magiccount, char **magic)
+static inline long
+decode_char (const unsigned char *p)
 {
-  int c, i;
-  long r = 0;
+  switch (encoding)
+    {
+    case 'b':
+      return ((long) p[0] << 8) | p[1];
+    case 'l':
+      return ((long) p[1] << 8) | p[0];
+    case 'B':
+      return (((long) p[0] << 24) | ((long) p[1] << 16)
+	      | ((long) p[2] << 8) | p[3]);
+    case 'L':
+      return (((long) p[3] << 24) | ((long) p[2] << 16)
+	      | ((long) p[1] << 8) | p[0]);
+    default:
+      return p[0];
+    }
+}
+
+/* Add the character C, which started at address START, to the scan
+   SCAN.  */
 
-  for (i = 0; i < encoding_bytes; i++)
+static void
+scan_char (strings_scan *scan, long c, file_ptr start)
+{
+  if (c >= 0 && c <= 255 && graphic_table[c])
     {
-      if (*magiccount)
+      if (scan->run_len < string_min)
 	{
-	  (*magiccount)--;
-	  c = *(*magic)++;
+	  if (scan->run_len == 0)
+	    scan->start = start;
+	  scan->buf[scan->run_len++] = c;
+	  if (scan->run_len == string_min)
+	    {
+	      /* We found a run of `string_min' graphic characters.
+		 Print up to the next non-graphic character.  */
+	      print_string_prefix (scan->filename, scan->start);
+	      fwrite (scan->buf, 1, string_min, stdout);
+	    }
 	}
       else
+	putchar (c);
+    }
+  else
+    {
+      if (scan->run_len == string_min)
+	putchar ('\n');
+      scan->run_len = 0;
+    }
+}
+
+/* Scan the LEN bytes at DATA, which follow the data already given to
+   SCAN.  */
+
+static void
+scan_bytes (strings_scan *scan, const unsigned char *data, size_t len)
+{
+  const unsigned char *end = data + len;
+
+  if (encoding_bytes == 1)
+    {
+      /* Single byte characters can be handled a run at a time.  */
+      while (data < end && !scan->stopped)
 	{
-	  if (stream == NULL)
-	    return EOF;
+	  const unsigned char *run;
+	  size_t n;
 
-	  /* Only use getc_unlocked if we found a declaration for it.
-	     Otherwise, libc is not thread safe by default, and we
-	     should not use it.  */
+	  if (scan->run_len == 0)
+	    {
+	      const unsigned char *p = data;
+
+	      /* Skip over the bytes which cannot start a string.  */
+	      while (p < end && !graphic_table[*p])
+		p++;
+	      if (scan->stop_point
+		  && scan->address + (p - data) >= scan->stop_point)
+		{
+		  /* A run would start at or beyond the stop point.  */
+		  scan->stopped = TRUE;
+		  break;
+		}
+	      scan->address += p - data;
+	      data = p;
+	      if (data == end)
+		break;
+	      scan->start = scan->address;
+	    }
 
-#if defined(HAVE_GETC_UNLOCKED) && HAVE_DECL_GETC_UNLOCKED
-	  c = getc_unlocked (stream);
-#else
-	  c = getc (stream);
-#endif
-	  if (c == EOF)
-	    return EOF;
-	}
+	  run = data;
+	  while (data < end && graphic_table[*data])
+	    data++;
+	  n = data - run;
+	  scan->address += n;
 
-      (*address)++;
-      r = (r << 8) | (c & 0xff);
+	  if (scan->run_len < string_min)
+	    {
+	      size_t need = string_min - scan->run_len;
+
+	      if (n < need)
+		{
+		  memcpy (scan->buf + scan->run_len, run, n);
+		  scan->run_len += n;
+		}
+	      else
+		{
+		  memcpy (scan->buf + scan->run_len, run, need);
+		  scan->run_len = string_min;
+		  print_string_prefix (scan->filename, scan->start);
+		  fwrite (scan->buf, 1, string_min, stdout);
+		  fwrite (run + need, 1, n - need, stdout);
+		}
+	    }
+	  else
+	    fwrite (run, 1, n, stdout);
+
+	  if (data < end)
+	    {
+	      /* DATA is a non-graphic byte, which ends the run.  */
+	      if (scan->run_len == string_min)
+		putchar ('\n');
+	      scan->run_len = 0;
+	      scan->address++;
+	      data++;
+	    }
+	}
+      return;
     }
 
-  switch (encoding)
+  while (data < end && !scan->stopped)
     {
-    default:
-      break;
-    case 'l':
-      r = ((r & 0xff) << 8) | ((r & 0xff00) >> 8);
-      break;
-    case 'L':
-      r = (((r & 0xff) << 24) | ((r & 0xff00) << 8)
-	   | ((r & 0xff0000) >> 8) | ((r & 0xff000000) >> 24));
-      break;
-    }
+      long c;
+
+      if (scan->run_len == 0
+	  && scan->stop_point
+	  && scan->address - scan->partial_len >= scan->stop_point)
+	{
+	  scan->stopped = TRUE;
+	  break;
+	}
 
-  return r;
+      if (scan->partial_len == 0 && end - data >= encoding_bytes)
+	{
+	  c = decode_char (data);
+	  data += encoding_bytes;
+	  scan->address += encoding_bytes;
+	}
+      else
+	{
+	  /* Gather the bytes of a character split between pieces.  */
+	  while (scan->partial_len < encoding_bytes && data < end)
+	    {
+	      scan->partial[scan->partial_len++] = *data++;
+	      scan->address++;
+	    }
+	  if (scan->partial_len < encoding_bytes)
+	    break;
+	  c = decode_char (scan->partial);
+	  scan->partial_len = 0;
+	}
+
+      scan_char (scan, c, scan->address - encoding_bytes);
+    }
 }
-
+
+/* The size of the pieces in which files are read.  */
+#define STRINGS_CHUNK_SIZE (256 * 1024)
+
 /* Find the strings in file FILENAME, read from STREAM.
    Assume that STREAM is positioned so that the next byte read
    is at address ADDRESS in the file.
@@ -537,124 +756,58 @@ get_char (FILE *stream, file_ptr *address, int *magiccount, char **magic)
    to be processed before the data in STREAM.
    MAGIC is the address of the buffer and
    MAGICCOUNT is how many characters are in it.
-   Those characters come at address ADDRESS and the data in STREAM follow.  */
+   Those characters come at address ADDRESS and the data in STREAM follow.
+
+   Rather than reading a character at a time, the data is scanned in
+   pieces of up to STRINGS_CHUNK_SIZE bytes.  */
 
 static void
 print_strings (const char *filename, FILE *stream, file_ptr address,
 	       int stop_point, int magiccount, char *magic)
 {
-  char *buf = (char *) xmalloc (sizeof (char) * (string_min + 1));
+  strings_scan scan;
 
-  while (1)
-    {
-      file_ptr start;
-      int i;
-      long c;
+  scan.filename = filename;
+  scan.address = address;
+  scan.stop_point = stop_point;
+  scan.stopped = FALSE;
+  scan.start = address;
+  scan.run_len = 0;
+  scan.buf = (char *) xmalloc (sizeof (char) * (string_min + 1));
+  scan.partial_len = 0;
 
-      /* See if the next `string_min' chars are all graphic chars.  */
-    tryline:
-      if (stop_point && address >= stop_point)
-	break;
-      start = address;
-      for (i = 0; i < string_min; i++)
-	{
-	  c = get_char (stream, &address, &magiccount, &magic);
-	  if (c == EOF)
-	    {
-	      free (buf);
-	      return;
-	    }
-	  if (! STRING_ISGRAPHIC (c))
-	    /* Found a non-graphic.  Try again starting with next char.  */
-	    goto tryline;
-	  buf[i] = c;
-	}
-
-      /* We found a run of `string_min' graphic characters.  Print up
-	 to the next non-graphic character.  */
-
-      if (print_filenames)
-	printf ("%s: ", filename);
-      if (print_addresses)
-	switch (address_radix)
-	  {
-	  case 8:
-#ifdef HAVE_LONG_LONG
-	    if (sizeof (start) > sizeof (long))
-	      {
-# ifndef __MSVCRT__
-	        printf ("%7llo ", (unsigned long long) start);
-# else
-	        printf ("%7I64o ", (unsigned long long) start);
-# endif
-	      }
-	    else
-#elif !BFD_HOST_64BIT_LONG
-	    if (start != (unsigned long) start)
-	      printf ("++%7lo ", (unsigned long) start);
-	    else
-#endif
-	      printf ("%7lo ", (unsigned long) start);
-	    break;
-
-	  case 10:
-#ifdef HAVE_LONG_LONG
-	    if (sizeof (start) > sizeof (long))
-	      {
-# ifndef __MSVCRT__
-	        printf ("%7lld ", (unsigned long long) start);
-# else
-	        printf ("%7I64d ", (unsigned long long) start);
-# endif
-	      }
-	    else
-#elif !BFD_HOST_64BIT_LONG
-	    if (start != (unsigned long) start)
-	      printf ("++%7ld ", (unsigned long) start);
-	    else
-#endif
-	      printf ("%7ld ", (long) start);
-	    break;
-
-	  case 16:
-#ifdef HAVE_LONG_LONG
-	    if (sizeof (start) > sizeof (long))
-	      {
-# ifndef __MSVCRT__
-	        printf ("%7llx ", (unsigned long long) start);
-# else
-	        printf ("%7I64x ", (unsigned long long) start);
-# endif
-	      }
-	    else
-#elif !BFD_HOST_64BIT_LONG
-	    if (start != (unsigned long) start)
-	      printf ("%lx%8.8lx ", (unsigned long) (start >> 32),
-		      (unsigned long) (start & 0xffffffff));
-	    else
-#endif
-	      printf ("%7lx ", (unsigned long) start);
-	    break;
-	  }
+  if (magiccount > 0)
+    scan_bytes (&scan, (const unsigned char *) magic, magiccount);
 
-      buf[i] = '\0';
-      fputs (buf, stdout);
-
-      while (1)
+  if (stream != NULL)
+    {
+      unsigned char *chunk = (unsigned char *) xmalloc (STRINGS_CHUNK_SIZE);
+      int fd = fileno (stream);
+
+      /* Use read rather than fread, which would not return until it
+	 had filled the whole chunk.  A pipe or terminal returns what is
+	 available, so strings in a stream which is still being written,
+	 as with "tail -f log | strings", are printed as they arrive.  */
+      while (!scan.stopped)
 	{
-	  c = get_char (stream, &address, &magiccount, &magic);
-	  if (c == EOF)
-	    break;
-	  if (! STRING_ISGRAPHIC (c))
+	  ssize_t n = read (fd, chunk, STRINGS_CHUNK_SIZE);
+
+	  if (n < 0 && errno == EINTR)
+	    continue;
+	  if (n <= 0)
 	    break;
-	  putchar (c);
+	  scan_bytes (&scan, chunk, n);
 	}
-
-      putchar ('\n');
+      free (chunk);
     }
-  free (buf);
+
+  /* A string that runs up to the end of the data is still printed.  */
+  if (scan.run_len == string_min)
+    putchar ('\n');
+
+  free (scan.buf);
 }
-
+
 static void
 usage (FILE *stream, int status)
 {
@@ -0,0 +1,22 @@
+	.file 1 "addr2line-1.c"
+	.text
+	.globl	a2l_first
+a2l_first:
+	.loc 1 10 0
+	.long	0
+	.loc 1 11 0
+	.long	1
+	.loc 1 13 0
+	.long	2
+	.loc 1 12 0
+	.long	3
+	.globl	a2l_second
+a2l_second:
+	.loc 1 20 0
+	.long	4
+	.loc 1 21 0
+	.long	5
+	.loc 1 7 0
+	.long	6
+	.loc 1 30 0
+	.long	7
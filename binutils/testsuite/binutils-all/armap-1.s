@@ -0,0 +1,4 @@
+	.globl	map_sym_foo
+	.data
+map_sym_foo:
+	.long	1
@@ -0,0 +1,4 @@
+	.globl	map_sym_bar
+	.data
+map_sym_bar:
+	.long	2
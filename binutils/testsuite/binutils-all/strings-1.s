@@ -0,0 +1,7 @@
+	.data
+	.ascii "datastring_in_data"
+	.byte 0
+
+	.section .nonalloc,""
+	.ascii "nonalloc_string"
+	.byte 0
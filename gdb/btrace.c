@@ -592,7 +592,7 @@ static void
 btrace_compute_ftrace (struct btrace_thread_info *btinfo,
 		       VEC (btrace_block_s) *btrace)
 {
-  struct btrace_function *begin, *end;
+  struct btrace_function *begin, *end, *bfun;
   struct gdbarch *gdbarch;
   unsigned int blk;
   int level;
@@ -666,6 +666,20 @@ btrace_compute_ftrace (struct btrace_thread_info *btinfo,
 	}
     }
 
+  /* Index the function segments we added.  When extending an existing
+     trace, these are the ones following the previous END.  */
+  if (btinfo->end != NULL)
+    bfun = btinfo->end->flow.next;
+  else
+    bfun = begin;
+
+  for (; bfun != NULL; bfun = bfun->flow.next)
+    {
+      gdb_assert (bfun->number == VEC_length (btrace_fun_p,
+					       btinfo->functions) + 1);
+      VEC_safe_push (btrace_fun_p, btinfo->functions, bfun);
+    }
+
   btinfo->begin = begin;
   btinfo->end = end;
 
@@ -945,6 +959,7 @@ btrace_clear (struct thread_info *tp)
 
   btinfo->begin = NULL;
   btinfo->end = NULL;
+  VEC_free (btrace_fun_p, btinfo->functions);
 
   btrace_clear_history (btinfo);
 }
@@ -1254,13 +1269,29 @@ btrace_find_insn_by_number (struct btrace_insn_iterator *it,
 			    unsigned int number)
 {
   const struct btrace_function *bfun;
-  unsigned int end;
+  unsigned int low, high, end;
+
+  /* Binary search for the last function segment starting at or before
+     NUMBER.  Function segments are ordered by their instruction
+     offsets.  */
+  low = 0;
+  high = VEC_length (btrace_fun_p, btinfo->functions);
+  if (high == 0)
+    return 0;
 
-  for (bfun = btinfo->end; bfun != NULL; bfun = bfun->flow.prev)
-    if (bfun->insn_offset <= number)
-      break;
+  while (high - low > 1)
+    {
+      unsigned int mid = low + (high - low) / 2;
 
-  if (bfun == NULL)
+      bfun = VEC_index (btrace_fun_p, btinfo->functions, mid);
+      if (bfun->insn_offset <= number)
+	low = mid;
+      else
+	high = mid;
+    }
+
+  bfun = VEC_index (btrace_fun_p, btinfo->functions, low);
+  if (number < bfun->insn_offset)
     return 0;
 
   end = bfun->insn_offset + VEC_length (btrace_insn_s, bfun->insn);
@@ -1450,24 +1481,16 @@ btrace_find_call_by_number (struct btrace_call_iterator *it,
 {
   const struct btrace_function *bfun;
 
-  for (bfun = btinfo->end; bfun != NULL; bfun = bfun->flow.prev)
-    {
-      unsigned int bnum;
-
-      bnum = bfun->number;
-      if (number == bnum)
-	{
-	  it->btinfo = btinfo;
-	  it->function = bfun;
-	  return 1;
-	}
+  /* Functions are numbered consecutively starting at one.  */
+  if (number == 0 || number > VEC_length (btrace_fun_p, btinfo->functions))
+    return 0;
 
-      /* Functions are ordered and numbered consecutively.  We could bail out
-	 earlier.  On the other hand, it is very unlikely that we search for
-	 a nonexistent function.  */
-  }
+  bfun = VEC_index (btrace_fun_p, btinfo->functions, number - 1);
+  gdb_assert (bfun->number == number);
 
-  return 0;
+  it->btinfo = btinfo;
+  it->function = bfun;
+  return 1;
 }
 
 /* See btrace.h.  */
@@ -113,6 +113,10 @@ struct btrace_function
   enum btrace_function_flag flags;
 };
 
+/* A vector of branch trace function segments.  */
+typedef struct btrace_function *btrace_fun_p;
+DEF_VEC_P (btrace_fun_p);
+
 /* A branch trace instruction iterator.  */
 struct btrace_insn_iterator
 {
@@ -196,6 +200,12 @@ struct btrace_thread_info
   struct btrace_function *begin;
   struct btrace_function *end;
 
+  /* All function segments from BEGIN to END, indexed by their number
+     minus one.  This allows looking up a function segment by its
+     number or by one of its instruction numbers without walking the
+     trace.  */
+  VEC (btrace_fun_p) *functions;
+
   /* The function level offset.  When added to each function's LEVEL,
      this normalizes the function levels such that the smallest level
      becomes zero.  */
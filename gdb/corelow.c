@@ -46,6 +46,13 @@
 #include "completer.h"
 #include "filestuff.h"
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#ifndef MAP_FAILED
+#define MAP_FAILED ((void *) -1)
+#endif
+#endif
+
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
 #endif
@@ -74,6 +81,30 @@ static struct gdbarch *core_gdbarch = NULL;
    unix child targets.  */
 static struct target_section_table *core_data;
 
+/* A read-only mapping of the contents of one of the sections in
+   CORE_DATA.  Memory reads from large core files are served straight
+   from these mappings, rather than being copied through BFD's stdio
+   buffers on every access.  */
+
+struct core_section_map
+{
+  /* The section contents, or NULL if not mapped (yet).  */
+  const gdb_byte *data;
+
+  /* The page aligned address and length of the mapping.  */
+  void *map_addr;
+  bfd_size_type map_len;
+
+  /* Nonzero if the section can not be mapped; reads then go through
+     BFD.  */
+  int failed;
+};
+
+/* The mappings for CORE_DATA, indexed in parallel with its sections,
+   and created lazily by core_map_section.  */
+
+static struct core_section_map *core_section_maps;
+
 static void core_files_info (struct target_ops *);
 
 static struct core_fns *sniff_core_bfd (bfd *);
@@ -203,6 +234,21 @@ core_close (struct target_ops *self)
 
       if (core_data)
 	{
+#ifdef HAVE_MMAP
+	  struct target_section *p;
+
+	  if (core_section_maps != NULL)
+	    for (p = core_data->sections; p < core_data->sections_end; p++)
+	      {
+		struct core_section_map *map
+		  = &core_section_maps[p - core_data->sections];
+
+		if (map->data != NULL)
+		  munmap (map->map_addr, map->map_len);
+	      }
+#endif
+	  xfree (core_section_maps);
+	  core_section_maps = NULL;
 	  xfree (core_data->sections);
 	  xfree (core_data);
 	  core_data = NULL;
@@ -352,6 +398,9 @@ core_open (const char *arg, int from_tty)
 			   &core_data->sections_end))
     error (_("\"%s\": Can't find sections: %s"),
 	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
+  core_section_maps
+    = XCNEWVEC (struct core_section_map,
+		core_data->sections_end - core_data->sections);
 
   /* If we have no exec file, try to set the architecture from the
      core file.  We don't do this unconditionally since an exec file
@@ -680,6 +729,90 @@ get_core_siginfo (bfd *abfd, gdb_byte *readbuf, ULONGEST offset, ULONGEST len)
   return len;
 }
 
+#ifdef HAVE_MMAP
+
+/* Return the contents of the core section P, mapping them if this has
+   not been done yet.  Return NULL if the section can't be mapped.  */
+
+static const gdb_byte *
+core_map_section (struct target_section *p)
+{
+  struct core_section_map *map = &core_section_maps[p - core_data->sections];
+  asection *asect = p->the_bfd_section;
+  bfd_size_type size = bfd_get_section_size (asect);
+  /* The page size, used when mmapping.  */
+  static int pagesize;
+  void *data;
+
+  if (map->data != NULL || map->failed)
+    return map->data;
+
+  if (pagesize == 0)
+    pagesize = getpagesize ();
+
+  /* Only map sections which are large enough for this to be worth it,
+     and never map past the end of a truncated core file: touching
+     such pages would raise SIGBUS.  BFD reports short reads as
+     errors instead.  */
+  map->failed = 1;
+  if ((bfd_get_section_flags (core_bfd, asect) & SEC_HAS_CONTENTS) == 0
+      || bfd_is_section_compressed (core_bfd, asect)
+      || size <= 4 * pagesize
+      || (ufile_ptr) asect->filepos + size > bfd_get_size (core_bfd))
+    return NULL;
+
+  data = bfd_mmap (core_bfd, 0, size, PROT_READ, MAP_PRIVATE,
+		   asect->filepos, &map->map_addr, &map->map_len);
+  if (data == MAP_FAILED)
+    return NULL;
+
+  map->failed = 0;
+  map->data = data;
+  return map->data;
+}
+
+#endif /* HAVE_MMAP */
+
+/* Read or write memory of the core file.  Reads from large sections
+   are satisfied from mappings of the core file where possible; all
+   other transfers go through BFD.  */
+
+static enum target_xfer_status
+core_xfer_memory (gdb_byte *readbuf, const gdb_byte *writebuf,
+		  ULONGEST offset, ULONGEST len, ULONGEST *xfered_len)
+{
+#ifdef HAVE_MMAP
+  if (readbuf != NULL && len > 0)
+    {
+      struct target_section *p;
+
+      /* Like section_table_xfer_memory_partial, use the first section
+	 that contains OFFSET.  */
+      for (p = core_data->sections; p < core_data->sections_end; p++)
+	if (offset >= p->addr && offset < p->endaddr)
+	  {
+	    const gdb_byte *data = core_map_section (p);
+
+	    if (data != NULL)
+	      {
+		if (len > p->endaddr - offset)
+		  len = p->endaddr - offset;
+		memcpy (readbuf, data + (offset - p->addr), len);
+		*xfered_len = len;
+		return TARGET_XFER_OK;
+	      }
+	    break;
+	  }
+    }
+#endif /* HAVE_MMAP */
+
+  return section_table_xfer_memory_partial (readbuf, writebuf,
+					    offset, len, xfered_len,
+					    core_data->sections,
+					    core_data->sections_end,
+					    NULL);
+}
+
 static enum target_xfer_status
 core_xfer_partial (struct target_ops *ops, enum target_object object,
 		   const char *annex, gdb_byte *readbuf,
@@ -689,11 +822,7 @@ core_xfer_partial (struct target_ops *ops, enum target_object object,
   switch (object)
     {
     case TARGET_OBJECT_MEMORY:
-      return section_table_xfer_memory_partial (readbuf, writebuf,
-						offset, len, xfered_len,
-						core_data->sections,
-						core_data->sections_end,
-						NULL);
+      return core_xfer_memory (readbuf, writebuf, offset, len, xfered_len);
 
     case TARGET_OBJECT_AUXV:
       if (readbuf)
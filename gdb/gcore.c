@@ -549,6 +549,65 @@ objfile_find_memory_regions (struct target_ops *self,
   return 0;
 }
 
+/* The granularity at which gcore_write_contents looks for blocks of
+   zeros that need not be written.  */
+#define GCORE_ZERO_BLOCK 4096
+
+/* Return nonzero if the SIZE bytes at BUF are all zero.  */
+
+static int
+gcore_all_zero (const gdb_byte *buf, bfd_size_type size)
+{
+  return size == 0 || (buf[0] == 0 && memcmp (buf, buf + 1, size - 1) == 0);
+}
+
+/* Write the SIZE bytes at MEMHUNK to OSEC of OBFD at OFFSET, skipping
+   any blocks of zeros.  The core file is created afresh, so skipped
+   blocks read back as zeros, and on file systems that support them
+   take no disk space at all.  If LAST is nonzero, this is the end of
+   the section's contents; its final block is always written so that
+   the file is extended to its full size.  Return zero on failure.  */
+
+static int
+gcore_write_contents (bfd *obfd, asection *osec, const gdb_byte *memhunk,
+		      file_ptr offset, bfd_size_type size, int last)
+{
+  bfd_size_type start = 0;
+
+  while (start < size)
+    {
+      bfd_size_type end, block;
+
+      /* Skip leading zero blocks, but never the final block of the
+	 section.  */
+      block = min (size - start, GCORE_ZERO_BLOCK);
+      if ((!last || start + block < size)
+	  && gcore_all_zero (memhunk + start, block))
+	{
+	  start += block;
+	  continue;
+	}
+
+      /* Collect the run of blocks that must be written.  */
+      end = start + block;
+      while (end < size)
+	{
+	  block = min (size - end, GCORE_ZERO_BLOCK);
+	  if ((!last || end + block < size)
+	      && gcore_all_zero (memhunk + end, block))
+	    break;
+	  end += block;
+	}
+
+      if (!bfd_set_section_contents (obfd, osec, memhunk + start,
+				     offset + start, end - start))
+	return 0;
+      start = end;
+    }
+
+  return 1;
+}
+
 static void
 gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 {
@@ -583,7 +642,8 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 		   paddress (target_gdbarch (), bfd_section_vma (obfd, osec)));
 	  break;
 	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk, offset, size))
+      if (!gcore_write_contents (obfd, osec, memhunk, offset, size,
+				 size == total_size))
 	{
 	  warning (_("Failed to write corefile contents (%s)."),
 		   bfd_errmsg (bfd_get_error ()));
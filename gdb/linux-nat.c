@@ -623,6 +623,12 @@ linux_child_set_syscall_catchpoint (struct target_ops *self,
 
 /* List of known LWPs.  */
 struct lwp_info *lwp_list;
+
+/* Hash table indexing the LWPs in LWP_LIST by their lwp id, so that
+   find_lwp_pid does not have to walk the whole list.  Processes with
+   thousands of threads otherwise make every wait status we collect
+   cost a linear scan.  */
+static htab_t lwp_lwpid_htab;
 
 
 /* Original signal mask.  */
@@ -698,6 +704,80 @@ lwp_free (struct lwp_info *lp)
   xfree (lp);
 }
 
+/* Hash function for LWP_LWPID_HTAB.  Entries are lwp_info objects;
+   lookups are done with the lwp id only.  */
+
+static hashval_t
+lwp_info_hash (const void *ap)
+{
+  const struct lwp_info *lp = ap;
+
+  return ptid_get_lwp (lp->ptid);
+}
+
+/* Equality function for LWP_LWPID_HTAB.  A is an lwp_info entry and
+   B points to the lwp id being looked up.  */
+
+static int
+lwp_lwpid_htab_eq (const void *a, const void *b)
+{
+  const struct lwp_info *entry = a;
+  const int *lwpid = b;
+
+  return ptid_get_lwp (entry->ptid) == *lwpid;
+}
+
+/* Return the LWP_LWPID_HTAB slot for the lwp id LWPID, creating the
+   table if necessary.  */
+
+static void **
+lwp_lwpid_htab_slot (int lwpid, enum insert_option insert)
+{
+  if (lwp_lwpid_htab == NULL)
+    lwp_lwpid_htab = htab_create (100, lwp_info_hash, lwp_lwpid_htab_eq,
+				  NULL);
+
+  return htab_find_slot_with_hash (lwp_lwpid_htab, &lwpid, lwpid, insert);
+}
+
+/* Record LP, which has just been added to LWP_LIST, in
+   LWP_LWPID_HTAB.  */
+
+static void
+lwp_lwpid_htab_add_lwp (struct lwp_info *lp)
+{
+  void **slot = lwp_lwpid_htab_slot (ptid_get_lwp (lp->ptid), INSERT);
+
+  /* Like the LWP_LIST walk this replaces, find the most recently
+     added LWP with this id.  */
+  *slot = lp;
+}
+
+/* Remove LP from LWP_LWPID_HTAB.  LP must already have been unlinked
+   from LWP_LIST.  */
+
+static void
+lwp_lwpid_htab_remove_lwp (struct lwp_info *lp)
+{
+  int lwpid = ptid_get_lwp (lp->ptid);
+  void **slot = lwp_lwpid_htab_slot (lwpid, NO_INSERT);
+  struct lwp_info *other;
+
+  if (slot == NULL || *slot != lp)
+    return;
+
+  /* If a stale LWP with the same id is still listed, it becomes the
+     one found by find_lwp_pid again.  */
+  for (other = lwp_list; other != NULL; other = other->next)
+    if (ptid_get_lwp (other->ptid) == lwpid)
+      {
+	*slot = other;
+	return;
+      }
+
+  htab_clear_slot (lwp_lwpid_htab, slot);
+}
+
 /* Remove all LWPs belong to PID from the lwp list.  */
 
 static void
@@ -718,6 +798,7 @@ purge_lwp_list (int pid)
 	  else
 	    lpprev->next = lp->next;
 
+	  lwp_lwpid_htab_remove_lwp (lp);
 	  lwp_free (lp);
 	}
       else
@@ -758,6 +839,7 @@ add_initial_lwp (ptid_t ptid)
 
   lp->next = lwp_list;
   lwp_list = lp;
+  lwp_lwpid_htab_add_lwp (lp);
 
   return lp;
 }
@@ -804,6 +886,7 @@ delete_lwp (ptid_t ptid)
   else
     lwp_list = lp->next;
 
+  lwp_lwpid_htab_remove_lwp (lp);
   lwp_free (lp);
 }
 
@@ -813,7 +896,7 @@ delete_lwp (ptid_t ptid)
 static struct lwp_info *
 find_lwp_pid (ptid_t ptid)
 {
-  struct lwp_info *lp;
+  void **slot;
   int lwp;
 
   if (ptid_lwp_p (ptid))
@@ -821,11 +904,11 @@ find_lwp_pid (ptid_t ptid)
   else
     lwp = ptid_get_pid (ptid);
 
-  for (lp = lwp_list; lp; lp = lp->next)
-    if (lwp == ptid_get_lwp (lp->ptid))
-      return lp;
+  slot = lwp_lwpid_htab_slot (lwp, NO_INSERT);
+  if (slot == NULL)
+    return NULL;
 
-  return NULL;
+  return *slot;
 }
 
 /* Call CALLBACK with its second argument set to DATA for every LWP in
@@ -108,15 +108,15 @@ msymbol_hash (const char *string)
   return hash;
 }
 
-/* Add the minimal symbol SYM to an objfile's minsym hash table, TABLE.  */
+/* Add the minimal symbol SYM to an objfile's minsym hash table, TABLE,
+   which has SIZE buckets.  */
 static void
 add_minsym_to_hash_table (struct minimal_symbol *sym,
-			  struct minimal_symbol **table)
+			  struct minimal_symbol **table, unsigned int size)
 {
   if (sym->hash_next == NULL)
     {
-      unsigned int hash
-	= msymbol_hash (MSYMBOL_LINKAGE_NAME (sym)) % MINIMAL_SYMBOL_HASH_SIZE;
+      unsigned int hash = msymbol_hash (MSYMBOL_LINKAGE_NAME (sym)) % size;
 
       sym->hash_next = table[hash];
       table[hash] = sym;
@@ -124,15 +124,15 @@ add_minsym_to_hash_table (struct minimal_symbol *sym,
 }
 
 /* Add the minimal symbol SYM to an objfile's minsym demangled hash table,
-   TABLE.  */
+   TABLE, which has SIZE buckets.  */
 static void
 add_minsym_to_demangled_hash_table (struct minimal_symbol *sym,
-                                  struct minimal_symbol **table)
+				    struct minimal_symbol **table,
+				    unsigned int size)
 {
   if (sym->demangled_hash_next == NULL)
     {
-      unsigned int hash = msymbol_hash_iw (MSYMBOL_SEARCH_NAME (sym))
-	% MINIMAL_SYMBOL_HASH_SIZE;
+      unsigned int hash = msymbol_hash_iw (MSYMBOL_SEARCH_NAME (sym)) % size;
 
       sym->demangled_hash_next = table[hash];
       table[hash] = sym;
@@ -168,8 +168,8 @@ lookup_minimal_symbol (const char *name, const char *sfile,
   struct bound_minimal_symbol found_file_symbol = { NULL, NULL };
   struct bound_minimal_symbol trampoline_symbol = { NULL, NULL };
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
-  unsigned int dem_hash = msymbol_hash_iw (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
+  unsigned int dem_hash = msymbol_hash_iw (name);
 
   int needtofreename = 0;
   const char *modified_name;
@@ -207,9 +207,11 @@ lookup_minimal_symbol (const char *name, const char *sfile,
 	    {
             /* Select hash list according to pass.  */
             if (pass == 1)
-              msymbol = objfile->per_bfd->msymbol_hash[hash];
+              msymbol = objfile->per_bfd->msymbol_hash
+		[hash % objfile->per_bfd->msymbol_hash_size];
             else
-              msymbol = objfile->per_bfd->msymbol_demangled_hash[dem_hash];
+              msymbol = objfile->per_bfd->msymbol_demangled_hash
+		[dem_hash % objfile->per_bfd->msymbol_hash_size];
 
             while (msymbol != NULL && found_symbol.minsym == NULL)
 		{
@@ -328,7 +330,7 @@ iterate_over_minimal_symbols (struct objfile *objf, const char *name,
   int (*cmp) (const char *, const char *);
 
   /* The first pass is over the ordinary hash table.  */
-  hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  hash = msymbol_hash (name) % objf->per_bfd->msymbol_hash_size;
   iter = objf->per_bfd->msymbol_hash[hash];
   cmp = (case_sensitivity == case_sensitive_on ? strcmp : strcasecmp);
   while (iter)
@@ -339,7 +341,7 @@ iterate_over_minimal_symbols (struct objfile *objf, const char *name,
     }
 
   /* The second pass is over the demangled table.  */
-  hash = msymbol_hash_iw (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  hash = msymbol_hash_iw (name) % objf->per_bfd->msymbol_hash_size;
   iter = objf->per_bfd->msymbol_demangled_hash[hash];
   while (iter)
     {
@@ -359,7 +361,7 @@ lookup_minimal_symbol_text (const char *name, struct objfile *objf)
   struct bound_minimal_symbol found_symbol = { NULL, NULL };
   struct bound_minimal_symbol found_file_symbol = { NULL, NULL };
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
 
   for (objfile = object_files;
        objfile != NULL && found_symbol.minsym == NULL;
@@ -368,7 +370,8 @@ lookup_minimal_symbol_text (const char *name, struct objfile *objf)
       if (objf == NULL || objf == objfile
 	  || objf == objfile->separate_debug_objfile_backlink)
 	{
-	  for (msymbol = objfile->per_bfd->msymbol_hash[hash];
+	  for (msymbol = objfile->per_bfd->msymbol_hash
+		 [hash % objfile->per_bfd->msymbol_hash_size];
 	       msymbol != NULL && found_symbol.minsym == NULL;
 	       msymbol = msymbol->hash_next)
 	    {
@@ -409,7 +412,7 @@ lookup_minimal_symbol_by_pc_name (CORE_ADDR pc, const char *name,
   struct objfile *objfile;
   struct minimal_symbol *msymbol;
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
 
   for (objfile = object_files;
        objfile != NULL;
@@ -418,7 +421,8 @@ lookup_minimal_symbol_by_pc_name (CORE_ADDR pc, const char *name,
       if (objf == NULL || objf == objfile
 	  || objf == objfile->separate_debug_objfile_backlink)
 	{
-	  for (msymbol = objfile->per_bfd->msymbol_hash[hash];
+	  for (msymbol = objfile->per_bfd->msymbol_hash
+		 [hash % objfile->per_bfd->msymbol_hash_size];
 	       msymbol != NULL;
 	       msymbol = msymbol->hash_next)
 	    {
@@ -442,7 +446,7 @@ lookup_minimal_symbol_solib_trampoline (const char *name,
   struct minimal_symbol *msymbol;
   struct bound_minimal_symbol found_symbol = { NULL, NULL };
 
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
 
   for (objfile = object_files;
        objfile != NULL;
@@ -451,7 +455,8 @@ lookup_minimal_symbol_solib_trampoline (const char *name,
       if (objf == NULL || objf == objfile
 	  || objf == objfile->separate_debug_objfile_backlink)
 	{
-	  for (msymbol = objfile->per_bfd->msymbol_hash[hash];
+	  for (msymbol = objfile->per_bfd->msymbol_hash
+		 [hash % objfile->per_bfd->msymbol_hash_size];
 	       msymbol != NULL;
 	       msymbol = msymbol->hash_next)
 	    {
@@ -845,13 +850,14 @@ lookup_minimal_symbol_and_objfile (const char *name)
 {
   struct bound_minimal_symbol result;
   struct objfile *objfile;
-  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+  unsigned int hash = msymbol_hash (name);
 
   ALL_OBJFILES (objfile)
     {
       struct minimal_symbol *msym;
 
-      for (msym = objfile->per_bfd->msymbol_hash[hash];
+      for (msym = objfile->per_bfd->msymbol_hash
+	     [hash % objfile->per_bfd->msymbol_hash_size];
 	   msym != NULL;
 	   msym = msym->hash_next)
 	{
@@ -1153,19 +1159,40 @@ compact_minimal_symbols (struct minimal_symbol *msymbol, int mcount,
 
 /* Build (or rebuild) the minimal symbol hash tables.  This is necessary
    after compacting or sorting the table since the entries move around
-   thus causing the internal minimal_symbol pointers to become jumbled.  */
+   thus causing the internal minimal_symbol pointers to become jumbled.
+   The tables are grown so that the average chain length stays below
+   one; a fixed number of buckets makes lookups in objfiles with
+   hundreds of thousands of minimal symbols walk very long chains.  */
   
 static void
 build_minimal_symbol_hash_tables (struct objfile *objfile)
 {
+  struct objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+  unsigned int size = per_bfd->msymbol_hash_size;
   int i;
   struct minimal_symbol *msym;
 
-  /* Clear the hash tables.  */
-  for (i = 0; i < MINIMAL_SYMBOL_HASH_SIZE; i++)
+  if (size < (unsigned int) per_bfd->minimal_symbol_count)
     {
-      objfile->per_bfd->msymbol_hash[i] = 0;
-      objfile->per_bfd->msymbol_demangled_hash[i] = 0;
+      /* Keep the size odd so that the modulus uses every bit of the
+	 hash.  The old, smaller tables are simply abandoned on the
+	 obstack.  */
+      size = per_bfd->minimal_symbol_count | 1;
+      per_bfd->msymbol_hash
+	= OBSTACK_CALLOC (&per_bfd->storage_obstack, size,
+			  struct minimal_symbol *);
+      per_bfd->msymbol_demangled_hash
+	= OBSTACK_CALLOC (&per_bfd->storage_obstack, size,
+			  struct minimal_symbol *);
+      per_bfd->msymbol_hash_size = size;
+    }
+  else
+    {
+      /* Clear the hash tables.  */
+      memset (per_bfd->msymbol_hash, 0,
+	      size * sizeof (struct minimal_symbol *));
+      memset (per_bfd->msymbol_demangled_hash, 0,
+	      size * sizeof (struct minimal_symbol *));
     }
 
   /* Now, (re)insert the actual entries.  */
@@ -1175,12 +1202,13 @@ build_minimal_symbol_hash_tables (struct objfile *objfile)
        i--, msym++)
     {
       msym->hash_next = 0;
-      add_minsym_to_hash_table (msym, objfile->per_bfd->msymbol_hash);
+      add_minsym_to_hash_table (msym, per_bfd->msymbol_hash, size);
 
       msym->demangled_hash_next = 0;
       if (MSYMBOL_SEARCH_NAME (msym) != MSYMBOL_LINKAGE_NAME (msym))
 	add_minsym_to_demangled_hash_table (msym,
-                                            objfile->per_bfd->msymbol_demangled_hash);
+					    per_bfd->msymbol_demangled_hash,
+					    size);
     }
 }
 
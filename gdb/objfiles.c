@@ -151,6 +151,13 @@ get_objfile_bfd_data (struct objfile *objfile, struct bfd *abfd)
       storage->filename_cache = bcache_xmalloc (NULL, NULL);
       storage->macro_cache = bcache_xmalloc (NULL, NULL);
       storage->language_of_main = language_unknown;
+      storage->msymbol_hash_size = MINIMAL_SYMBOL_HASH_SIZE;
+      storage->msymbol_hash
+	= OBSTACK_CALLOC (&storage->storage_obstack,
+			  MINIMAL_SYMBOL_HASH_SIZE, struct minimal_symbol *);
+      storage->msymbol_demangled_hash
+	= OBSTACK_CALLOC (&storage->storage_obstack,
+			  MINIMAL_SYMBOL_HASH_SIZE, struct minimal_symbol *);
     }
 
   return storage;
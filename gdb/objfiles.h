@@ -163,7 +163,9 @@ struct objstats
 extern void print_objfile_statistics (void);
 extern void print_symbol_bcache_statistics (void);
 
-/* Number of entries in the minimal symbol hash table.  */
+/* Minimum number of entries in the minimal symbol hash tables.  The
+   tables are grown to match the number of minimal symbols when they
+   are installed; see build_minimal_symbol_hash_tables.  */
 #define MINIMAL_SYMBOL_HASH_SIZE 2039
 
 /* Some objfile data is hung off the BFD.  This enables sharing of the
@@ -239,14 +241,20 @@ struct objfile_per_bfd_storage
 
   unsigned int minsyms_read : 1;
 
-  /* This is a hash table used to index the minimal symbols by name.  */
+  /* The number of buckets in each of the two minimal symbol hash
+     tables below.  This is never less than MINIMAL_SYMBOL_HASH_SIZE.  */
 
-  struct minimal_symbol *msymbol_hash[MINIMAL_SYMBOL_HASH_SIZE];
+  unsigned int msymbol_hash_size;
+
+  /* This is a hash table used to index the minimal symbols by name.
+     It has msymbol_hash_size entries.  */
+
+  struct minimal_symbol **msymbol_hash;
 
   /* This hash table is used to index the minimal symbols by their
-     demangled names.  */
+     demangled names.  It has msymbol_hash_size entries.  */
 
-  struct minimal_symbol *msymbol_demangled_hash[MINIMAL_SYMBOL_HASH_SIZE];
+  struct minimal_symbol **msymbol_demangled_hash;
 };
 
 /* Master structure for keeping track of each file from which
@@ -0,0 +1,67 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#ifndef NUM_THREADS
+#define NUM_THREADS 100
+#endif
+
+static pthread_t threads[NUM_THREADS];
+
+volatile int flag = 1;
+
+static void *
+thread_function (void *arg)
+{
+  while (flag)
+    usleep (1000);
+  return NULL;
+}
+
+void
+marker (void)
+{
+}
+
+void
+all_threads_started (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, thread_function, NULL);
+
+  all_threads_started ();
+
+  while (flag)
+    {
+      marker ();
+      usleep (1000);
+    }
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_join (threads[i], NULL);
+
+  return 0;
+}
@@ -0,0 +1,45 @@
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+class Threads (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, count):
+        super (Threads, self).__init__ ("threads")
+        self.count = count
+
+    def warm_up(self):
+        gdb.execute("break marker", False, True)
+        gdb.execute("continue", False, True)
+
+    def _resume(self, r):
+        # Each continue resumes every thread, and each breakpoint hit
+        # stops them all again.
+        for _ in range(0, r):
+            gdb.execute("continue", False, True)
+
+    def _attach(self, r):
+        pid = gdb.selected_inferior().pid
+        for _ in range(0, r):
+            gdb.execute("detach", False, True)
+            gdb.execute("attach %d" % pid, False, True)
+
+    def execute_test(self):
+        for i in range(1, 5):
+            func = lambda: self._resume(i * self.count)
+            self.measure.measure(func, i * self.count)
+        for i in range(1, 3):
+            func = lambda: self._attach(i)
+            self.measure.measure(func, "attach-%d" % i)
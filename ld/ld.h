@@ -97,9 +97,24 @@ struct wildcard_spec {
   struct flag_info *section_flag_list;
 };
 
+/* How the name of a wildcard_spec is matched against section names.
+   Patterns of the form "prefix*suffix" are matched without fnmatch,
+   and other wildcards are only passed to fnmatch once their literal
+   prefix and suffix match.  */
+
+typedef enum {
+  match_literal, match_prefix_suffix, match_fnmatch
+} wildcard_match_type;
+
 struct wildcard_list {
   struct wildcard_list *next;
   struct wildcard_spec spec;
+  /* The remaining fields are set from SPEC.NAME by init_wildcard_match,
+     called from analyze_walk_wild_section_handler.  */
+  wildcard_match_type match_type;
+  unsigned int name_len;
+  unsigned int prefix_len;
+  unsigned int suffix_len;
 };
 
 #define BYTE_SIZE	(1)
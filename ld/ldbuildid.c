@@ -32,6 +32,7 @@ bfd_boolean
 validate_build_id_style (const char *style)
 {
  if ((streq (style, "md5")) || (streq (style, "sha1"))
+     || (streq (style, "fast"))
 #ifndef __MINGW32__
      || (streq (style, "uuid"))
 #endif
@@ -44,7 +45,7 @@ validate_build_id_style (const char *style)
 bfd_size_type
 compute_build_id_size (const char *style)
 {
-  if (streq (style, "md5") || streq (style, "uuid"))
+  if (streq (style, "md5") || streq (style, "uuid") || streq (style, "fast"))
     return  128 / 8;
 
   if (streq (style, "sha1"))
@@ -93,6 +94,160 @@ read_hex (const char xdigit)
   return 0;
 }
 
+/* A fast non-cryptographic 128-bit hash for --build-id=fast, in the
+   style of xxHash64.  Four independent lanes each consume a word of
+   every 32-byte stripe, so hashing runs at close to memory speed.
+   Words are read little-endian, so the ID does not depend on the host,
+   nor on how the contents are split between calls.  */
+
+struct fast_hash_ctx
+{
+  bfd_uint64_t lane[4];
+  bfd_uint64_t total;
+  unsigned char buf[32];
+  unsigned int buflen;
+};
+
+#define FAST_HASH_CONST(hi, lo) (((bfd_uint64_t) (hi) << 32) | (lo))
+#define FAST_HASH_PRIME1 FAST_HASH_CONST (0x9e3779b1, 0x85ebca87)
+#define FAST_HASH_PRIME2 FAST_HASH_CONST (0xc2b2ae3d, 0x27d4eb4f)
+#define FAST_HASH_PRIME3 FAST_HASH_CONST (0x165667b1, 0x9e3779f9)
+#define FAST_HASH_PRIME4 FAST_HASH_CONST (0x85ebca77, 0xc2b2ae63)
+#define FAST_HASH_PRIME5 FAST_HASH_CONST (0x27d4eb2f, 0x165667c5)
+
+static inline bfd_uint64_t
+fast_hash_rotl (bfd_uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+static inline bfd_uint64_t
+fast_hash_get64 (const unsigned char *p)
+{
+  return ((bfd_uint64_t) p[0]
+	  | ((bfd_uint64_t) p[1] << 8)
+	  | ((bfd_uint64_t) p[2] << 16)
+	  | ((bfd_uint64_t) p[3] << 24)
+	  | ((bfd_uint64_t) p[4] << 32)
+	  | ((bfd_uint64_t) p[5] << 40)
+	  | ((bfd_uint64_t) p[6] << 48)
+	  | ((bfd_uint64_t) p[7] << 56));
+}
+
+static inline bfd_uint64_t
+fast_hash_round (bfd_uint64_t acc, bfd_uint64_t input)
+{
+  acc += input * FAST_HASH_PRIME2;
+  acc = fast_hash_rotl (acc, 31);
+  return acc * FAST_HASH_PRIME1;
+}
+
+static inline bfd_uint64_t
+fast_hash_merge (bfd_uint64_t h, bfd_uint64_t lane)
+{
+  h ^= fast_hash_round (0, lane);
+  return h * FAST_HASH_PRIME1 + FAST_HASH_PRIME4;
+}
+
+static inline bfd_uint64_t
+fast_hash_avalanche (bfd_uint64_t h)
+{
+  h ^= h >> 33;
+  h *= FAST_HASH_PRIME2;
+  h ^= h >> 29;
+  h *= FAST_HASH_PRIME3;
+  h ^= h >> 32;
+  return h;
+}
+
+static void
+fast_hash_init_ctx (struct fast_hash_ctx *ctx)
+{
+  ctx->lane[0] = FAST_HASH_PRIME1 + FAST_HASH_PRIME2;
+  ctx->lane[1] = FAST_HASH_PRIME2;
+  ctx->lane[2] = 0;
+  ctx->lane[3] = -FAST_HASH_PRIME1;
+  ctx->total = 0;
+  ctx->buflen = 0;
+}
+
+static inline void
+fast_hash_stripe (struct fast_hash_ctx *ctx, const unsigned char *p)
+{
+  ctx->lane[0] = fast_hash_round (ctx->lane[0], fast_hash_get64 (p));
+  ctx->lane[1] = fast_hash_round (ctx->lane[1], fast_hash_get64 (p + 8));
+  ctx->lane[2] = fast_hash_round (ctx->lane[2], fast_hash_get64 (p + 16));
+  ctx->lane[3] = fast_hash_round (ctx->lane[3], fast_hash_get64 (p + 24));
+}
+
+static void
+fast_hash_process_bytes (const void *buffer, size_t len, void *arg)
+{
+  struct fast_hash_ctx *ctx = (struct fast_hash_ctx *) arg;
+  const unsigned char *p = (const unsigned char *) buffer;
+
+  ctx->total += len;
+  if (ctx->buflen != 0)
+    {
+      size_t n = sizeof ctx->buf - ctx->buflen;
+
+      if (n > len)
+	n = len;
+      memcpy (ctx->buf + ctx->buflen, p, n);
+      ctx->buflen += n;
+      p += n;
+      len -= n;
+      if (ctx->buflen < sizeof ctx->buf)
+	return;
+      fast_hash_stripe (ctx, ctx->buf);
+      ctx->buflen = 0;
+    }
+
+  for (; len >= sizeof ctx->buf; p += sizeof ctx->buf, len -= sizeof ctx->buf)
+    fast_hash_stripe (ctx, p);
+
+  memcpy (ctx->buf, p, len);
+  ctx->buflen = len;
+}
+
+static void
+fast_hash_finish_ctx (struct fast_hash_ctx *ctx, unsigned char *id_bits)
+{
+  bfd_uint64_t h, h2;
+  unsigned int i;
+
+  h = (fast_hash_rotl (ctx->lane[0], 1) + fast_hash_rotl (ctx->lane[1], 7)
+       + fast_hash_rotl (ctx->lane[2], 12) + fast_hash_rotl (ctx->lane[3], 18));
+  for (i = 0; i < 4; i++)
+    h = fast_hash_merge (h, ctx->lane[i]);
+  h += ctx->total;
+
+  /* Fold in the bytes left over from the last stripe.  */
+  for (i = 0; i + 8 <= ctx->buflen; i += 8)
+    {
+      h ^= fast_hash_round (0, fast_hash_get64 (ctx->buf + i));
+      h = fast_hash_rotl (h, 27) * FAST_HASH_PRIME1 + FAST_HASH_PRIME4;
+    }
+  for (; i < ctx->buflen; i++)
+    {
+      h ^= ctx->buf[i] * FAST_HASH_PRIME5;
+      h = fast_hash_rotl (h, 11) * FAST_HASH_PRIME1;
+    }
+
+  /* Derive the second half by merging the lanes in the other order.  */
+  h2 = h;
+  for (i = 4; i-- > 0; )
+    h2 = fast_hash_merge (h2, fast_hash_rotl (ctx->lane[i], 23));
+
+  h = fast_hash_avalanche (h);
+  h2 = fast_hash_avalanche (h2 ^ h);
+  for (i = 0; i < 8; i++)
+    {
+      id_bits[i] = (h >> (8 * i)) & 0xff;
+      id_bits[i + 8] = (h2 >> (8 * i)) & 0xff;
+    }
+}
+
 bfd_boolean
 generate_build_id (bfd *abfd,
 		   const char *style,
@@ -118,6 +273,15 @@ generate_build_id (bfd *abfd,
 	return FALSE;
       sha1_finish_ctx (&ctx, id_bits);
     }
+  else if (streq (style, "fast"))
+    {
+      struct fast_hash_ctx ctx;
+
+      fast_hash_init_ctx (&ctx);
+      if (!(*checksum_contents) (abfd, &fast_hash_process_bytes, &ctx))
+	return FALSE;
+      fast_hash_finish_ctx (&ctx, id_bits);
+    }
 #ifndef __MINGW32__
   else if (streq (style, "uuid"))
     {
@@ -142,6 +142,76 @@ name_match (const char *pattern, const char *name)
   return strcmp (pattern, name);
 }
 
+/* The number of section names matched against wild statement patterns,
+   and the number of those matches which needed fnmatch.  Reported by
+   --stats.  */
+unsigned long lang_wild_match_count;
+unsigned long lang_wild_fnmatch_count;
+
+/* Set up the fields of SEC used by wildcard_match.  */
+
+static void
+init_wildcard_match (struct wildcard_list *sec)
+{
+  const char *name = sec->spec.name;
+  size_t len, prefix, suffix;
+
+  sec->match_type = match_literal;
+  sec->name_len = 0;
+  sec->prefix_len = 0;
+  sec->suffix_len = 0;
+  if (name == NULL || !wildcardp (name))
+    return;
+
+  /* The literal characters before the first and after the last
+     character which might be special to fnmatch.  */
+  len = strlen (name);
+  prefix = strcspn (name, "?*[\\");
+  suffix = 0;
+  while (suffix < len - prefix
+	 && strchr ("?*[]\\", name[len - suffix - 1]) == NULL)
+    suffix++;
+
+  sec->name_len = len;
+  sec->prefix_len = prefix;
+  sec->suffix_len = suffix;
+  if (prefix + 1 + suffix == len && name[prefix] == '*')
+    sec->match_type = match_prefix_suffix;
+  else
+    sec->match_type = match_fnmatch;
+}
+
+/* Return TRUE if section NAME matches the name of section spec SEC.
+   This is equivalent to name_match, but is faster for wildcards.  */
+
+static bfd_boolean
+wildcard_match (const struct wildcard_list *sec, const char *name)
+{
+  const char *pattern = sec->spec.name;
+
+  lang_wild_match_count++;
+  if (sec->match_type == match_literal)
+    return strcmp (pattern, name) == 0;
+
+  if (strncmp (pattern, name, sec->prefix_len) != 0)
+    return FALSE;
+  if (sec->suffix_len != 0)
+    {
+      size_t len = strlen (name);
+
+      if (len < sec->prefix_len + sec->suffix_len
+	  || memcmp (name + len - sec->suffix_len,
+		     pattern + sec->name_len - sec->suffix_len,
+		     sec->suffix_len) != 0)
+	return FALSE;
+    }
+  if (sec->match_type == match_prefix_suffix)
+    return TRUE;
+
+  lang_wild_fnmatch_count++;
+  return fnmatch (pattern, name, 0) == 0;
+}
+
 /* If PATTERN is of the form archive:file, return a pointer to the
    separator.  If not, return NULL.  */
 
@@ -286,7 +356,7 @@ walk_wild_section_general (lang_wild_statement_type *ptr,
 	    {
 	      const char *sname = bfd_get_section_name (file->the_bfd, s);
 
-	      skip = name_match (sec->spec.name, sname) != 0;
+	      skip = !wildcard_match (sec, sname);
 	    }
 
 	  if (!skip)
@@ -350,6 +420,8 @@ is_simple_wild (const char *name)
 static bfd_boolean
 match_simple_wild (const char *pattern, const char *name)
 {
+  lang_wild_match_count++;
+
   /* The first four characters of the pattern are guaranteed valid
      non-wildcard characters.  So we can go faster.  */
   if (pattern[0] != name[0] || pattern[1] != name[1]
@@ -773,6 +845,9 @@ analyze_walk_wild_section_handler (lang_wild_statement_type *ptr)
   ptr->handler_data[3] = NULL;
   ptr->tree = NULL;
 
+  for (sec = ptr->section_list; sec != NULL; sec = sec->next)
+    init_wildcard_match (sec);
+
   /* Count how many wildcard_specs there are, and how many of those
      actually use wildcards in the name.  Also, bail out if any of the
      wildcard names are NULL. (Can this actually happen?
@@ -2586,6 +2661,139 @@ output_section_callback (lang_wild_statement_type *ptr,
     }
 }
 
+/* An input section statement created for a wild statement whose
+   sections are all sorted the same way, and the order in which it
+   was created.  */
+
+typedef struct
+{
+  lang_statement_union_type *stmt;
+  struct wildcard_list *sec;
+  size_t seq;
+} wild_sort_entry_type;
+
+typedef struct
+{
+  lang_output_section_statement_type *os;
+  wild_sort_entry_type *entries;
+  size_t count;
+  size_t alloc;
+} wild_sort_data_type;
+
+/* Return TRUE if wild_sort would insert each section of WILD into a
+   list which is kept sorted by a single ordering.  The sections can
+   then be collected and sorted once, rather than each one being
+   inserted by walking the list.  */
+
+static bfd_boolean
+wild_sort_is_uniform (lang_wild_statement_type *wild)
+{
+  struct wildcard_list *sec;
+  sort_type sorted;
+
+  if (wild->filenames_sorted
+      || wild->section_list == NULL
+      || wild->children.head != NULL)
+    return FALSE;
+
+  sorted = wild->section_list->spec.sorted;
+  if (sorted != by_name
+      && sorted != by_alignment
+      && sorted != by_name_alignment
+      && sorted != by_alignment_name)
+    return FALSE;
+
+  for (sec = wild->section_list->next; sec != NULL; sec = sec->next)
+    if (sec->spec.sorted != sorted)
+      return FALSE;
+
+  return TRUE;
+}
+
+/* Like output_section_callback, but collect the input section
+   statements to be sorted by wild_sorted.  */
+
+static void
+output_section_callback_sorted (lang_wild_statement_type *ptr ATTRIBUTE_UNUSED,
+				struct wildcard_list *sec,
+				asection *section,
+				struct flag_info *sflag_info,
+				lang_input_statement_type *file ATTRIBUTE_UNUSED,
+				void *data)
+{
+  wild_sort_data_type *sd = (wild_sort_data_type *) data;
+  lang_statement_list_type list;
+  wild_sort_entry_type *entry;
+
+  if (unique_section_p (section, sd->os))
+    return;
+
+  lang_list_init (&list);
+  lang_add_section (&list, section, sflag_info, sd->os);
+
+  /* If we are discarding the section, or it has already been added,
+     LIST.HEAD will be NULL.  */
+  if (list.head == NULL)
+    return;
+  ASSERT (list.head->header.next == NULL);
+
+  if (sd->count == sd->alloc)
+    {
+      sd->alloc = sd->alloc == 0 ? 64 : sd->alloc * 2;
+      sd->entries = (wild_sort_entry_type *)
+	xrealloc (sd->entries, sd->alloc * sizeof (*sd->entries));
+    }
+  entry = &sd->entries[sd->count];
+  entry->stmt = list.head;
+  entry->sec = sec;
+  entry->seq = sd->count;
+  sd->count++;
+}
+
+static int
+compare_wild_sort_entries (const void *a, const void *b)
+{
+  const wild_sort_entry_type *ea = (const wild_sort_entry_type *) a;
+  const wild_sort_entry_type *eb = (const wild_sort_entry_type *) b;
+  int ret;
+
+  ret = compare_section (ea->sec->spec.sorted,
+			 ea->stmt->input_section.section,
+			 eb->stmt->input_section.section);
+  if (ret != 0)
+    return ret;
+
+  /* Keep sections which compare equal in the order they were found,
+     as wild_sort does.  */
+  return ea->seq < eb->seq ? -1 : ea->seq > eb->seq;
+}
+
+/* Expand wild statement S, for which wild_sort_is_uniform is TRUE,
+   into OUTPUT.  */
+
+static void
+wild_sorted (lang_wild_statement_type *s,
+	     lang_output_section_statement_type *output)
+{
+  wild_sort_data_type sd;
+  size_t i;
+
+  sd.os = output;
+  sd.entries = NULL;
+  sd.count = 0;
+  sd.alloc = 0;
+  walk_wild (s, output_section_callback_sorted, &sd);
+
+  if (sd.count > 1)
+    qsort (sd.entries, sd.count, sizeof (*sd.entries),
+	   compare_wild_sort_entries);
+
+  for (i = 0; i < sd.count; i++)
+    lang_statement_append (&s->children, sd.entries[i].stmt,
+			   &sd.entries[i].stmt->header.next);
+  free (sd.entries);
+}
+
 /* Check if all sections in a wild statement for a particular FILE
    are readonly.  */
 
@@ -2884,6 +3092,8 @@ wild (lang_wild_statement_type *s,
 	  s->tree = NULL;
 	}
     }
+  else if (wild_sort_is_uniform (s))
+    wild_sorted (s, output);
   else
     walk_wild (s, output_section_callback, output);
 
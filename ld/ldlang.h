@@ -507,6 +507,8 @@ extern lang_statement_list_type file_chain;
 extern lang_statement_list_type input_file_chain;
 
 extern int lang_statement_iteration;
+extern unsigned long lang_wild_match_count;
+extern unsigned long lang_wild_fnmatch_count;
 extern struct asneeded_minfo **asneeded_list_tail;
 
 extern void (*output_bfd_hash_table_free_fn) (struct bfd_link_hash_table *);
@@ -515,6 +515,7 @@ main (int argc, char **argv)
       char *lim = (char *) sbrk (0);
 #endif
       long run_time = get_run_time () - start_time;
+      struct bfd_cache_stats cache_stats;
 
       fflush (stdout);
       fprintf (stderr, _("%s: total time in link: %ld.%06ld\n"),
@@ -523,6 +524,16 @@ main (int argc, char **argv)
       fprintf (stderr, _("%s: data size %ld\n"), program_name,
 	       (long) (lim - start_sbrk));
 #endif
+      bfd_cache_get_stats (&cache_stats);
+      fprintf (stderr, _("%s: files opened %lu, reopened %lu, evicted %lu\n"),
+	       program_name, cache_stats.opens, cache_stats.reopens,
+	       cache_stats.evictions);
+      fprintf (stderr, _("%s: file reads %lu, writes %lu, seeks %lu\n"),
+	       program_name, cache_stats.reads, cache_stats.writes,
+	       cache_stats.seeks);
+      fprintf (stderr, _("%s: section names matched against wildcards %lu,"
+			 " using fnmatch %lu\n"),
+	       program_name, lang_wild_match_count, lang_wild_fnmatch_count);
       fflush (stderr);
     }
 